@@ -0,0 +1,145 @@
+#pragma once
+#ifndef OPTIMIZATION_LIB_OBJECT_ARENA_H
+#define OPTIMIZATION_LIB_OBJECT_ARENA_H
+
+// STL includes
+#include <atomic>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+
+// TBB includes
+#include <tbb/enumerable_thread_specific.h>
+
+// A per-model arena for the objective function and data provider graphs. Objects (together with their shared_ptr control blocks)
+// are bump-allocated from large contiguous blocks, and individual deallocations are no-ops. Objectives and data providers are created
+// from within parallel loops, so each thread bumps its own region without locking. Every object created by MakeShared() holds a reference
+// to the region it was allocated from (an uncontended reference count, since regions are per thread), so the blocks of a region are
+// released at once when the arena and the last of these objects are destroyed.
+//
+// Memory of destroyed objects is never reused. The arena is reset when a model is loaded, so it should only be used for objects that
+// live as long as the model (e.g., the children of the seamless objective), and not for objects that are repeatedly created and
+// destroyed while the model is loaded (e.g., the position constraints of dragged faces), which would grow it until the model is unloaded.
+class ObjectArena
+{
+	class Region;
+
+
+public:
+	/**
+	 * Public type definitions
+	 */
+	template<typename T>
+	class Allocator
+	{
+	public:
+		using value_type = T;
+
+		explicit Allocator(std::shared_ptr<Region> region) :
+			region_(std::move(region))
+		{
+
+		}
+
+		template<typename U>
+		Allocator(const Allocator<U>& allocator) :
+			region_(allocator.region_)
+		{
+
+		}
+
+		T* allocate(const std::size_t n)
+		{
+			return static_cast<T*>(region_->Allocate(n * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T* p, const std::size_t n)
+		{
+			// Empty implementation (memory is released with the region)
+		}
+
+		template<typename U>
+		bool operator==(const Allocator<U>& allocator) const
+		{
+			return region_ == allocator.region_;
+		}
+
+		template<typename U>
+		bool operator!=(const Allocator<U>& allocator) const
+		{
+			return region_ != allocator.region_;
+		}
+
+	private:
+		template<typename U>
+		friend class Allocator;
+
+		std::shared_ptr<Region> region_;
+	};
+
+	/**
+	 * Constructors and destructor
+	 */
+	ObjectArena(const std::size_t initial_block_size = 1 << 20);
+	virtual ~ObjectArena();
+
+	/**
+	 * Public methods
+	 */
+	template<typename T, typename...Args>
+	std::shared_ptr<T> MakeShared(Args&&... args)
+	{
+		return std::allocate_shared<T>(Allocator<T>(GetLocalRegion()), std::forward<Args>(args)...);
+	}
+
+	/**
+	 * Getters
+	 */
+	std::size_t GetAllocatedBytes() const;
+
+private:
+	/**
+	 * Private type definitions
+	 */
+
+	// Bump allocator of a single thread (only the thread that owns a region allocates from it)
+	class Region
+	{
+	public:
+		/**
+		 * Constructors and destructor
+		 */
+		Region(const std::size_t initial_block_size);
+		virtual ~Region();
+
+		/**
+		 * Public methods
+		 */
+		void* Allocate(const std::size_t bytes, const std::size_t alignment);
+
+		/**
+		 * Getters
+		 */
+		std::size_t GetAllocatedBytes() const;
+
+	private:
+		/**
+		 * Private fields
+		 */
+		std::pmr::monotonic_buffer_resource memory_resource_;
+		std::atomic<std::size_t> allocated_bytes_;
+	};
+
+	/**
+	 * Private methods
+	 */
+	const std::shared_ptr<Region>& GetLocalRegion();
+
+	/**
+	 * Private fields
+	 */
+	std::size_t initial_block_size_;
+	tbb::enumerable_thread_specific<std::shared_ptr<Region>> regions_;
+};
+
+#endif
@@ -2,8 +2,14 @@
 #ifndef OPTIMIZATION_LIB_UPDATABLE_OBJECT_H
 #define OPTIMIZATION_LIB_UPDATABLE_OBJECT_H
 
+// STL includes
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
 // TBB includes
-#include <tbb/concurrent_vector.h>
+#include <tbb/flow_graph.h>
 
 // Eigen Includes
 #include <Eigen/Core>
@@ -11,8 +17,6 @@
 // Optimization lib includes
 #include "../data_providers/mesh_data_provider.h"
 
-//#include <unordered_set>
-
 class UpdatableObject
 {
 public:
@@ -26,7 +30,10 @@ public:
 	 * Public getters
 	 */
 	[[nodiscard]] std::shared_ptr<MeshDataProvider> GetMeshDataProvider() const;
-	const tbb::concurrent_vector<std::shared_ptr<UpdatableObject>>& GetDependencies() const;
+	const std::vector<std::shared_ptr<UpdatableObject>>& GetDependencies() const;
+
+	// Number of redundant dependency updates (of objects reachable through more than one path) eliminated from each update
+	std::size_t GetEliminatedRedundantUpdatesCount() const;
 	
 	/**
 	 * Public methods
@@ -34,23 +41,87 @@ public:
 	virtual void Initialize();
 	virtual void Update(const Eigen::VectorXd& x) = 0;
 	virtual void Update(const Eigen::VectorXd& x, const int32_t update_modifiers) = 0;
+
+	// Patch the dependency graph of this (root) object after a dependency was added to (or removed from) the dependencies of one of
+	// its dependents, instead of rebuilding the whole graph on the next update. If the dependency graph was invalidated by any
+	// other change since it was built, the graph is left stale and is rebuilt as usual. The dependency edit and the patch must not
+	// run concurrently with an update of this object (see IterativeMethod::LockIteration()).
+	void OnDependencyAdded(const UpdatableObject& dependent, const std::shared_ptr<UpdatableObject>& dependency);
+	void OnDependencyRemoved(const UpdatableObject& dependent, const std::shared_ptr<UpdatableObject>& dependency);
 	
 protected:
+	/**
+	 * Protected methods
+	 */
+
+	// Rebuilds the dependency layers if the dependency graph was invalidated since they were last built
+	void RefreshDependencyLayers();
+
+	// Updates all active dependencies. The dependency graph is executed as a TBB flow graph, so each dependency
+	// is updated as soon as its own dependencies are updated (there are no barriers between dependency layers).
+	void UpdateDependencies(const Eigen::VectorXd& x, const int32_t update_modifiers);
+
+	// Marks the dependency layers of all updatable objects as stale (e.g., when a subtree becomes active or inactive)
+	static void InvalidateDependencyLayers();
+
+	// Whether a dependency (and the subtree below it) has to be updated. Inactive dependencies are excluded from the dependency layers.
+	virtual bool IsDependencyActive(const std::shared_ptr<UpdatableObject>& dependency) const;
+
+	// Number of occurrences of a dependency in the dependencies of this object (objects that index their dependencies may override the linear scan)
+	virtual std::size_t CountDependency(const std::shared_ptr<UpdatableObject>& dependency) const;
+
 	/**
 	 * Protected Fields
 	 */
 
 	// Mesh data provider
 	std::shared_ptr<MeshDataProvider> mesh_data_provider_;
-	tbb::concurrent_vector<std::shared_ptr<UpdatableObject>> dependencies_;
-	std::vector<std::vector<std::shared_ptr<UpdatableObject>>> dependency_layers_;
+	std::vector<std::shared_ptr<UpdatableObject>> dependencies_;
 
 private:
+	/**
+	 * Private type definitions
+	 */
+	struct DependencyGraphNode
+	{
+		std::unique_ptr<tbb::flow::continue_node<tbb::flow::continue_msg>> node;
+
+		// Number of distinct active dependencies of the object (a node without predecessors is triggered by the source node)
+		std::size_t predecessors_count;
+
+		// Number of distinct dependents of the object in the graph (including this object, for its own dependencies)
+		std::size_t successors_count;
+	};
+
 	/**
 	 * Private methods
 	 */
-	void InitializeDependencyLayers(std::vector<std::vector<std::shared_ptr<UpdatableObject>>>& dependency_layers);
-	int BuildDependencyLayers(const std::shared_ptr<UpdatableObject>& updatable_object, std::vector<std::vector<std::shared_ptr<UpdatableObject>>>& dependency_layers) const;
+	void RebuildDependencyGraph();
+	int BuildDependencyLayers(const std::shared_ptr<UpdatableObject>& updatable_object, std::vector<std::vector<std::shared_ptr<UpdatableObject>>>& dependency_layers, std::unordered_map<const UpdatableObject*, std::pair<int, std::size_t>>& visited_objects) const;
+	void InitializeDependencyGraph(const std::vector<std::vector<std::shared_ptr<UpdatableObject>>>& dependency_layers);
+	bool IsDependencyGraphPatchable() const;
+	DependencyGraphNode* FindDependencyGraphNode(const UpdatableObject& dependent);
+	DependencyGraphNode& AddDependencyGraphNode(const std::shared_ptr<UpdatableObject>& updatable_object);
+	void ReleaseDependencyGraphNode(const std::shared_ptr<UpdatableObject>& updatable_object);
+	static std::vector<std::shared_ptr<UpdatableObject>> GetDistinctActiveDependencies(const UpdatableObject& updatable_object);
+
+	/**
+	 * Private fields
+	 */
+
+	// Version of the dependency graph the dependency layers were built for
+	std::size_t dependency_layers_version_;
+	std::size_t eliminated_redundant_updates_count_;
+	static std::atomic<std::size_t> dependency_graph_version_;
+
+	// Flow graph with a single node per dependency (declared before its nodes, so it is destroyed after them)
+	std::unique_ptr<tbb::flow::graph> dependency_graph_;
+	std::unique_ptr<tbb::flow::broadcast_node<tbb::flow::continue_msg>> dependency_graph_source_;
+	std::unordered_map<const UpdatableObject*, DependencyGraphNode> dependency_graph_nodes_;
+
+	// Arguments of the update currently executed by the flow graph
+	const Eigen::VectorXd* dependency_graph_x_;
+	int32_t dependency_graph_update_modifiers_;
 };
 
 #endif
\ No newline at end of file
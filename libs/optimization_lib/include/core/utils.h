@@ -127,6 +127,18 @@ public:
 		}
 		return seed;
 	}
+
+	// Generates a fingerprint of the sparsity pattern (dimensions, outer and inner indices) of a compressed sparse matrix
+	template <int StorageOrder_>
+	static std::size_t GeneratePatternHash(const Eigen::SparseMatrix<double, StorageOrder_>& A)
+	{
+		size_t seed = 0;
+		boost::hash_combine(seed, A.rows());
+		boost::hash_combine(seed, A.cols());
+		boost::hash_range(seed, A.outerIndexPtr(), A.outerIndexPtr() + A.outerSize() + 1);
+		boost::hash_range(seed, A.innerIndexPtr(), A.innerIndexPtr() + A.nonZeros());
+		return seed;
+	}
 };
 
 #endif
\ No newline at end of file
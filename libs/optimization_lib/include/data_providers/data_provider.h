@@ -23,16 +23,6 @@ public:
 	 */
 	DataProvider(const std::shared_ptr<MeshDataProvider>& mesh_data_provider);
 	virtual ~DataProvider();
-
-	/**
-	 * Getters
-	 */
-	const Eigen::SparseVector<double>& GetVariables() const;
-	double GetVariableValue(const RDS::SparseVariableIndex variable_index) const;
-	double GetVariableValue(const RDS::VertexIndex vertex_index, const CoordinateType coordinate_type) const;
-	
-protected:
-	Eigen::SparseVector<double> variables_;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,129 @@
+#pragma once
+#ifndef OPTIMIZATION_LIB_DATA_PROVIDER_REGISTRY_H
+#define OPTIMIZATION_LIB_DATA_PROVIDER_REGISTRY_H
+
+// STL includes
+#include <memory>
+#include <mutex>
+#include <map>
+#include <tuple>
+#include <atomic>
+#include <algorithm>
+
+// Optimization lib includes
+#include "../core/core.h"
+#include "./mesh_data_provider.h"
+#include "./empty_data_provider.h"
+#include "./coordinate_data_provider.h"
+#include "./coordinate_diff_data_provider.h"
+#include "./edge_pair_data_provider.h"
+#include "./face_fan_data_provider.h"
+
+// Interns the data providers of a mesh by identity, so objectives that depend on the same data share a single provider
+// (which is then updated once per update, instead of once per objective). Providers are held weakly, and a provider
+// that is no longer referenced by any objective is recreated on its next request (its entry is erased by a later sweep).
+class DataProviderRegistry
+{
+public:
+	/**
+	 * Constructors and destructor
+	 */
+	DataProviderRegistry();
+	virtual ~DataProviderRegistry();
+
+	/**
+	 * Public methods
+	 */
+	static std::shared_ptr<EmptyDataProvider> GetEmptyDataProvider(const std::shared_ptr<MeshDataProvider>& mesh_data_provider);
+	static std::shared_ptr<CoordinateDataProvider> GetCoordinateDataProvider(const std::shared_ptr<MeshDataProvider>& mesh_data_provider, const RDS::VertexIndex vertex_index, const RDS::CoordinateType coordinate_type);
+	static std::shared_ptr<CoordinateDiffDataProvider> GetCoordinateDiffDataProvider(const std::shared_ptr<MeshDataProvider>& mesh_data_provider, const RDS::VertexIndex vertex1_index, const RDS::VertexIndex vertex2_index, const RDS::CoordinateType coordinate_type);
+	static std::shared_ptr<EdgePairDataProvider> GetEdgePairDataProvider(const std::shared_ptr<MeshDataProvider>& mesh_data_provider, const RDS::EdgePairDescriptor& edge_pair_descriptor);
+	static std::shared_ptr<FaceFanDataProvider> GetFaceFanDataProvider(const std::shared_ptr<MeshDataProvider>& mesh_data_provider, const RDS::FaceFan& face_fan);
+
+	// Drops all interned providers (the mesh topology they were created for is no longer valid)
+	void Clear();
+
+	// Number of requests that were served by an existing provider instead of creating a duplicate one
+	std::size_t GetReusedDataProvidersCount() const;
+
+private:
+	/**
+	 * Private type definitions
+	 */
+
+	// Interned providers of a single type. Entries of providers that are no longer referenced are erased once the map doubles
+	// in size since it was last swept, so sweeping takes amortized constant time per created provider.
+	template<typename Key_, typename DataProviderType_>
+	struct DataProviders
+	{
+		std::map<Key_, std::weak_ptr<DataProviderType_>> map;
+		std::size_t sweep_size = min_sweep_size_;
+	};
+
+	/**
+	 * Private constants
+	 */
+	static constexpr std::size_t min_sweep_size_ = 64;
+
+	/**
+	 * Private methods
+	 */
+	template<typename DataProviderType_, typename Key_, typename CreateFunction_>
+	std::shared_ptr<DataProviderType_> GetOrCreate(DataProviders<Key_, DataProviderType_>& data_providers, const Key_& key, const CreateFunction_& create)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto& data_provider = data_providers.map[key];
+		if (auto existing_data_provider = data_provider.lock())
+		{
+			reused_data_providers_count_++;
+			return existing_data_provider;
+		}
+
+		auto new_data_provider = create();
+		data_provider = new_data_provider;
+		if (data_providers.map.size() >= data_providers.sweep_size)
+		{
+			EraseExpired(data_providers);
+		}
+
+		return new_data_provider;
+	}
+
+	template<typename Key_, typename DataProviderType_>
+	static void EraseExpired(DataProviders<Key_, DataProviderType_>& data_providers)
+	{
+		for (auto iterator = data_providers.map.begin(); iterator != data_providers.map.end();)
+		{
+			if (iterator->second.expired())
+			{
+				iterator = data_providers.map.erase(iterator);
+			}
+			else
+			{
+				++iterator;
+			}
+		}
+
+		data_providers.sweep_size = std::max(2 * data_providers.map.size(), min_sweep_size_);
+	}
+
+	template<typename Key_, typename DataProviderType_>
+	static void ClearDataProviders(DataProviders<Key_, DataProviderType_>& data_providers)
+	{
+		data_providers.map.clear();
+		data_providers.sweep_size = min_sweep_size_;
+	}
+
+	/**
+	 * Private fields
+	 */
+	std::mutex mutex_;
+	std::atomic<std::size_t> reused_data_providers_count_;
+	std::weak_ptr<EmptyDataProvider> empty_data_provider_;
+	DataProviders<std::pair<RDS::VertexIndex, RDS::CoordinateType>, CoordinateDataProvider> coordinate_data_providers_;
+	DataProviders<std::tuple<RDS::VertexIndex, RDS::VertexIndex, RDS::CoordinateType>, CoordinateDiffDataProvider> coordinate_diff_data_providers_;
+	DataProviders<RDS::EdgePairDescriptor, EdgePairDataProvider> edge_pair_data_providers_;
+	DataProviders<RDS::FaceFan, FaceFanDataProvider> face_fan_data_providers_;
+};
+
+#endif
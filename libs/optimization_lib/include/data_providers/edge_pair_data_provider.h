@@ -15,6 +15,27 @@
 class EdgePairDataProvider : public DataProvider
 {
 public:
+	/**
+	 * Public type definitions
+	 */
+
+	// Positions of the edge pair variables in GetVariableIndices() and GetVariableValues()
+	enum LocalVariableIndex : int32_t
+	{
+		Edge1Vertex1X,
+		Edge1Vertex1Y,
+		Edge1Vertex2X,
+		Edge1Vertex2Y,
+		Edge2Vertex1X,
+		Edge2Vertex1Y,
+		Edge2Vertex2X,
+		Edge2Vertex2Y,
+		Count_
+	};
+
+	using VariableIndices = Eigen::Matrix<RDS::SparseVariableIndex, LocalVariableIndex::Count_, 1>;
+	using VariableValues = Eigen::Matrix<double, LocalVariableIndex::Count_, 1>;
+
 	/**
 	 * Constructors and destructor
 	 */
@@ -30,6 +51,16 @@ public:
 	/**
 	 * Getters
 	 */
+	const VariableIndices& GetVariableIndices() const
+	{
+		return variable_indices_;
+	}
+
+	const VariableValues& GetVariableValues() const
+	{
+		return variable_values_;
+	}
+
 	const Eigen::Vector2d& EdgePairDataProvider::GetEdge1() const
 	{
 		return edge1_;
@@ -77,42 +108,42 @@ public:
 
 	int64_t EdgePairDataProvider::GetEdge1Vertex1XIndex() const
 	{
-		return edge1_v1_x_index_;
+		return variable_indices_.coeff(LocalVariableIndex::Edge1Vertex1X);
 	}
 
 	int64_t EdgePairDataProvider::GetEdge1Vertex1YIndex() const
 	{
-		return edge1_v1_y_index_;
+		return variable_indices_.coeff(LocalVariableIndex::Edge1Vertex1Y);
 	}
 
 	int64_t EdgePairDataProvider::GetEdge1Vertex2XIndex() const
 	{
-		return edge1_v2_x_index_;
+		return variable_indices_.coeff(LocalVariableIndex::Edge1Vertex2X);
 	}
 
 	int64_t EdgePairDataProvider::GetEdge1Vertex2YIndex() const
 	{
-		return edge1_v2_y_index_;
+		return variable_indices_.coeff(LocalVariableIndex::Edge1Vertex2Y);
 	}
 
 	int64_t EdgePairDataProvider::GetEdge2Vertex1XIndex() const
 	{
-		return edge2_v1_x_index_;
+		return variable_indices_.coeff(LocalVariableIndex::Edge2Vertex1X);
 	}
 
 	int64_t EdgePairDataProvider::GetEdge2Vertex1YIndex() const
 	{
-		return edge2_v1_y_index_;
+		return variable_indices_.coeff(LocalVariableIndex::Edge2Vertex1Y);
 	}
 
 	int64_t EdgePairDataProvider::GetEdge2Vertex2XIndex() const
 	{
-		return edge2_v2_x_index_;
+		return variable_indices_.coeff(LocalVariableIndex::Edge2Vertex2X);
 	}
 
 	int64_t EdgePairDataProvider::GetEdge2Vertex2YIndex() const
 	{
-		return edge2_v2_y_index_;
+		return variable_indices_.coeff(LocalVariableIndex::Edge2Vertex2Y);
 	}
 
 	double EdgePairDataProvider::GetEdge1XDiff() const
@@ -209,15 +240,8 @@ private:
 	RDS::VertexIndex edge2_v1_index_;
 	RDS::VertexIndex edge2_v2_index_;
 
-	int64_t edge1_v1_x_index_;
-	int64_t edge1_v1_y_index_;
-	int64_t edge1_v2_x_index_;
-	int64_t edge1_v2_y_index_;
-
-	int64_t edge2_v1_x_index_;
-	int64_t edge2_v1_y_index_;
-	int64_t edge2_v2_x_index_;
-	int64_t edge2_v2_y_index_;
+	VariableIndices variable_indices_;
+	VariableValues variable_values_;
 
 	double edge1_x_diff_;
 	double edge1_y_diff_;
@@ -4,6 +4,7 @@
 
 // STL includes
 #include <memory>
+#include <vector>
 
 // Eigen Includes
 #include <Eigen/Core>
@@ -36,6 +37,9 @@ public:
 
 private:
 	RDS::FaceFan face_fan_;
+
+	// Variable indices of each face fan slice, ordered as: x0, y0, x1, y1, x2, y2
+	std::vector<Eigen::Matrix<RDS::SparseVariableIndex, 6, 1>> slice_variable_indices_;
 	double angle_;
 	RDS::VertexIndex domain_vertex_index_;
 };
@@ -2,6 +2,9 @@
 #ifndef OPTIMIZATION_LIB_MESH_DATA_PROVIDER_H
 #define OPTIMIZATION_LIB_MESH_DATA_PROVIDER_H
 
+// STL includes
+#include <memory>
+
 // Eigen Includes
 #include <Eigen/Core>
 #include <Eigen/Sparse>
@@ -9,9 +12,27 @@
 // Optimization lib includes
 #include "../core/core.h"
 
+class DataProviderRegistry;
+class ObjectArena;
+
 class MeshDataProvider
 {
 public:
+	/**
+	 * Constructors and destructor
+	 */
+	MeshDataProvider();
+	virtual ~MeshDataProvider();
+
+	// Registry of the data providers defined over this mesh (see DataProviderRegistry)
+	DataProviderRegistry& GetDataProviderRegistry() const;
+
+	// Arena of the objectives and data providers created for the current model (see ObjectArena)
+	ObjectArena& GetObjectArena() const;
+
+	// Starts a new arena (e.g., when a new model is loaded). Objects created from the previous arena keep it alive until they are destroyed
+	void ResetObjectArena();
+
 	virtual const Eigen::MatrixX3i& GetDomainFaces() const = 0;
 	virtual const Eigen::MatrixX3d& GetDomainVertices() const = 0;
 	virtual const Eigen::MatrixX2i& GetDomainEdges() const = 0;
@@ -36,6 +57,10 @@ public:
 	// Relevant for objective functions that operate on triangle soups
 	virtual const Eigen::SparseMatrix<double>& GetCorrespondingVertexPairsCoefficients() const = 0;
 	virtual const Eigen::VectorXd& GetCorrespondingVertexPairsEdgeLength() const = 0;
+
+private:
+	std::unique_ptr<DataProviderRegistry> data_provider_registry_;
+	std::shared_ptr<ObjectArena> object_arena_;
 };
 
 #endif
\ No newline at end of file
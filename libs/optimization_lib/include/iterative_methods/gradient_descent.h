@@ -9,24 +9,30 @@
 #include <Eigen/Core>
 
 // Optimization lib includes
-#include "./iterative_methods/iterative_method.h"
+#include "./iterative_method.h"
 
 // https://en.wikipedia.org/wiki/Gradient_descent
 template <Eigen::StorageOptions StorageOrder_>
 class GradientDescent : public IterativeMethod<StorageOrder_>
 {
 public:
-	GradientDescent::GradientDescent(std::shared_ptr<ObjectiveFunction<StorageOrder_>> objective_function, const Eigen::VectorXd& x0) :
+	GradientDescent(std::shared_ptr<ObjectiveFunction<StorageOrder_, Eigen::VectorXd>> objective_function, const Eigen::VectorXd& x0) :
 		IterativeMethod(objective_function, x0)
 	{
 
 	}
 
-	GradientDescent::~GradientDescent()
+	virtual ~GradientDescent()
 	{
 
 	}
 
+protected:
+	ObjectiveFunctionBase::UpdateOptions GetIterationUpdateOptions() const override
+	{
+		return ObjectiveFunctionBase::UpdateOptions::Gradient;
+	}
+
 private:
 	void ComputeDescentDirection(Eigen::VectorXd& p) override
 	{
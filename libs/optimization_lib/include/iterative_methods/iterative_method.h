@@ -4,7 +4,11 @@
 
 // STL includes
 #include <memory>
+#include <mutex>
 #include <thread>
+#include <condition_variable>
+#include <functional>
+#include <vector>
 
 // Eigen includes
 #include <Eigen/Core>
@@ -43,6 +47,14 @@ public:
 		return objective_function_;
 	}
 
+	// Replaces the minimized objective function, keeping the current approximation. Must not be called while the iterative method is running.
+	void SetObjectiveFunction(const std::shared_ptr<ObjectiveFunction<StorageOrder_, Eigen::VectorXd>>& objective_function)
+	{
+		objective_function_ = objective_function;
+		objective_function_->UpdateLayers(x_);
+		ObjectiveFunctionChanged();
+	}
+
 	void Start()
 	{
 		std::lock_guard<std::mutex> lock(thread_state_mutex_);
@@ -53,17 +65,36 @@ public:
 			thread_ = std::thread([&]() {
 				while (true)
 				{
+					// A paused iterative method is woken up to run the functions posted to it, without iterating
 					std::unique_lock<std::mutex> lock(thread_state_mutex_);
-					cv_.wait(lock, [&] { return thread_state_ != ThreadState::Paused; });
+					cv_.wait(lock, [&] { return thread_state_ != ThreadState::Paused || !pending_functions_.empty(); });
 
-					if (thread_state_ == ThreadState::Terminating)
+					std::vector<std::function<void()>> pending_functions;
+					pending_functions.swap(pending_functions_);
+					const ThreadState thread_state = thread_state_;
+					if (thread_state == ThreadState::Terminating)
 					{
 						thread_state_ = ThreadState::Terminated;
-						break;
 					}
 					lock.unlock();
 
-					objective_function_->UpdateLayers(x_, DenseObjectiveFunction<StorageOrder_>::UpdateOptions::Gradient | DenseObjectiveFunction<StorageOrder_>::UpdateOptions::Hessian);
+					std::lock_guard<std::mutex> iteration_lock(iteration_mutex_);
+					for (auto& pending_function : pending_functions)
+					{
+						pending_function();
+					}
+
+					if (thread_state == ThreadState::Terminating)
+					{
+						break;
+					}
+
+					if (thread_state == ThreadState::Paused)
+					{
+						continue;
+					}
+
+					objective_function_->UpdateLayers(x_, GetIterationUpdateOptions());
 					ComputeDescentDirection(p_);
 					LineSearch(p_);
 				}
@@ -99,6 +130,31 @@ public:
 		}
 	}
 
+	// Waits for the current iteration (if any) to complete, and keeps the next iteration from starting until the returned lock is released.
+	// The objective function may be edited (e.g., children added or removed) while holding the lock.
+	std::unique_lock<std::mutex> LockIteration()
+	{
+		return std::unique_lock<std::mutex>(iteration_mutex_);
+	}
+
+	// Runs the given function on the iteration thread, before the next iteration starts, so the objective function can be edited (or its state
+	// published) without waiting for the current iteration to complete. Functions posted to a running (or paused) iterative method run in the
+	// order they are posted. If the iterative method is terminated, the function runs right away, on the calling thread.
+	void RunBetweenIterations(std::function<void()> function)
+	{
+		std::unique_lock<std::mutex> lock(thread_state_mutex_);
+		if (thread_state_ == ThreadState::Terminated)
+		{
+			lock.unlock();
+			std::lock_guard<std::mutex> iteration_lock(iteration_mutex_);
+			function();
+			return;
+		}
+
+		pending_functions_.push_back(std::move(function));
+		cv_.notify_one();
+	}
+
 	void Terminate()
 	{
 		std::unique_lock<std::mutex> lock(thread_state_mutex_);
@@ -140,6 +196,27 @@ public:
 		flip_avoiding_line_search_enabled_ = false;
 	}
 
+protected:
+	/**
+	 * Protected methods
+	 */
+	virtual void ObjectiveFunctionChanged()
+	{
+		// Empty implementation
+	}
+
+	// The layers of the objective function that are updated at the current approximation, before the descent direction is computed
+	virtual ObjectiveFunctionBase::UpdateOptions GetIterationUpdateOptions() const
+	{
+		return ObjectiveFunctionBase::UpdateOptions::Gradient | ObjectiveFunctionBase::UpdateOptions::Hessian;
+	}
+
+	// Called after the line search moved the approximation by step_size * p, with the objective values before and after the step
+	virtual void StepTaken(const Eigen::VectorXd& p, const double step_size, const double previous_value, const double value)
+	{
+		// Empty implementation
+	}
+
 private:
 	/**
 	 * Private data type definitions
@@ -181,11 +258,13 @@ private:
 		 */
 		double current_value = objective_function_->GetValue();
 		double updated_value;
+		double current_step_size;
 		int current_iteration = 0;
 		Eigen::MatrixXd current_x;
 		while (current_iteration < max_backtracking_iterations_)
 		{
-			current_x = x_ + step_size * p;
+			current_step_size = step_size;
+			current_x = x_ + current_step_size * p;
 			objective_function_->UpdateLayers(current_x, DenseObjectiveFunction<StorageOrder_>::UpdateOptions::Value);
 			updated_value = objective_function_->GetValue();
 
@@ -201,11 +280,13 @@ private:
 			current_iteration++;
 		}
 
-		objective_function_->UpdateLayers(current_x, DenseObjectiveFunction<StorageOrder_>::UpdateOptions::ValuePerVertex | DenseObjectiveFunction<StorageOrder_>::UpdateOptions::ValuePerEdge);
+		{
+			std::lock_guard<std::mutex> x_lock(x_mutex_);
+			x_ = std::move(current_x);
+			approximation_invalidated_ = true;
+		}
 
-		std::lock_guard<std::mutex> x_lock(x_mutex_);
-		x_ = std::move(current_x);
-		approximation_invalidated_ = true;
+		StepTaken(p, current_step_size, current_value, updated_value);
 	}
 
 	/**
@@ -217,6 +298,10 @@ private:
 	std::condition_variable cv_;
 	mutable std::mutex thread_state_mutex_;
 	mutable std::mutex x_mutex_;
+	std::mutex iteration_mutex_;
+
+	// Functions to run before the next iteration (see RunBetweenIterations())
+	std::vector<std::function<void()>> pending_functions_;
 
 	// Objective function
 	std::shared_ptr<ObjectiveFunction<StorageOrder_, Eigen::VectorXd>> objective_function_;
@@ -0,0 +1,199 @@
+#pragma once
+#ifndef OPTIMIZATION_LIB_LBFGS_METHOD_H
+#define OPTIMIZATION_LIB_LBFGS_METHOD_H
+
+// STL includes
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <limits>
+
+// Eigen includes
+#include <Eigen/Core>
+
+// Optimization lib includes
+#include "./iterative_method.h"
+
+// Limited-memory BFGS. The inverse hessian is approximated from the last history_length pairs of steps (s = x_k+1 - x_k) and
+// gradient changes (y = g_k+1 - g_k), and applied to the gradient by the two-loop recursion. Only values and gradients of the
+// objective function are evaluated, so neither local hessians (and their PSD projections) nor the global hessian are ever computed.
+// https://en.wikipedia.org/wiki/Limited-memory_BFGS
+template <Eigen::StorageOptions StorageOrder_>
+class LBFGSMethod : public IterativeMethod<StorageOrder_>
+{
+public:
+	LBFGSMethod(std::shared_ptr<ObjectiveFunction<StorageOrder_, Eigen::VectorXd>> objective_function, const Eigen::VectorXd& x0, const int64_t history_length = 10) :
+		IterativeMethod(objective_function, x0),
+		history_length_(std::max<int64_t>(history_length, 1)),
+		pairs_count_(0),
+		latest_pair_index_(0),
+		has_previous_iterate_(false),
+		objective_function_definition_version_(0)
+	{
+
+	}
+
+	virtual ~LBFGSMethod()
+	{
+
+	}
+
+	/**
+	 * Getters
+	 */
+	int64_t GetHistoryLength() const
+	{
+		return history_length_;
+	}
+
+	/**
+	 * Setters
+	 */
+
+	// Takes effect (and clears the current history) on the next iteration
+	void SetHistoryLength(const int64_t history_length)
+	{
+		history_length_ = std::max<int64_t>(history_length, 1);
+	}
+
+protected:
+	void ObjectiveFunctionChanged() override
+	{
+		ClearHistory();
+		has_previous_iterate_ = false;
+	}
+
+	ObjectiveFunctionBase::UpdateOptions GetIterationUpdateOptions() const override
+	{
+		return ObjectiveFunctionBase::UpdateOptions::Gradient;
+	}
+
+private:
+	void ClearHistory()
+	{
+		pairs_count_ = 0;
+		latest_pair_index_ = 0;
+	}
+
+	void InitializeHistory(const int64_t variables_count, const int64_t history_length)
+	{
+		s_history_.assign(history_length, Eigen::VectorXd::Zero(variables_count));
+		y_history_.assign(history_length, Eigen::VectorXd::Zero(variables_count));
+		rho_history_.assign(history_length, 0);
+		alpha_.assign(history_length, 0);
+		ClearHistory();
+	}
+
+	void UpdateHistory(const Eigen::VectorXd& x, const Eigen::VectorXd& g)
+	{
+		// Pairs that violate the curvature condition (s.y > 0) would break the positive definiteness of the approximation, and are skipped
+		const double sy = (x - previous_x_).dot(g - previous_g_);
+		if (sy <= std::numeric_limits<double>::epsilon() * (g - previous_g_).squaredNorm())
+		{
+			return;
+		}
+
+		// The new pair overwrites the oldest one once the history is full
+		const int64_t history_length = static_cast<int64_t>(s_history_.size());
+		const int64_t pair_index = (pairs_count_ == 0) ? 0 : (latest_pair_index_ + 1) % history_length;
+		s_history_[pair_index].noalias() = x - previous_x_;
+		y_history_[pair_index].noalias() = g - previous_g_;
+		rho_history_[pair_index] = 1.0 / sy;
+		latest_pair_index_ = pair_index;
+		pairs_count_ = std::min(pairs_count_ + 1, history_length);
+	}
+
+	void ComputeDescentDirection(Eigen::VectorXd& p) override
+	{
+		const auto& x = this->GetX();
+		const auto& g = this->GetObjectiveFunction()->GetGradient();
+		const int64_t variables_count = g.rows();
+		const int64_t history_length = history_length_;
+
+		if (static_cast<int64_t>(s_history_.size()) != history_length || s_history_[0].rows() != variables_count)
+		{
+			InitializeHistory(variables_count, history_length);
+		}
+
+		// Pairs collected before the objective function was changed (e.g., a weight was set or a constraint was added) describe
+		// the curvature of a different function, so they are discarded along with the previous iterate
+		const std::size_t objective_function_definition_version = this->GetObjectiveFunction()->GetDefinitionVersion();
+		if (objective_function_definition_version != objective_function_definition_version_)
+		{
+			ObjectiveFunctionChanged();
+			objective_function_definition_version_ = objective_function_definition_version;
+		}
+
+		if (has_previous_iterate_)
+		{
+			UpdateHistory(x, g);
+		}
+
+		/**
+		 * Two-loop recursion, from the latest pair to the oldest one and back
+		 */
+		p = -g;
+		for (int64_t i = 0; i < pairs_count_; i++)
+		{
+			const int64_t pair_index = (latest_pair_index_ - i + history_length) % history_length;
+			alpha_[pair_index] = rho_history_[pair_index] * s_history_[pair_index].dot(p);
+			p -= alpha_[pair_index] * y_history_[pair_index];
+		}
+
+		if (pairs_count_ > 0)
+		{
+			// Initial inverse hessian approximation gamma * I, with gamma = s.y / y.y of the latest pair
+			const auto& y = y_history_[latest_pair_index_];
+			p *= 1.0 / (rho_history_[latest_pair_index_] * y.squaredNorm());
+		}
+		else
+		{
+			// Without curvature information, the length of the first step is bounded by 1
+			p *= std::min(1.0, 1.0 / std::max(g.norm(), std::numeric_limits<double>::min()));
+		}
+
+		for (int64_t i = pairs_count_ - 1; i >= 0; i--)
+		{
+			const int64_t pair_index = (latest_pair_index_ - i + history_length) % history_length;
+			const double beta = rho_history_[pair_index] * y_history_[pair_index].dot(p);
+			p += (alpha_[pair_index] - beta) * s_history_[pair_index];
+		}
+
+		// The approximation is positive definite in exact arithmetic, so this only guards against round-off, by restarting from steepest descent
+		if (g.dot(p) >= 0)
+		{
+			ClearHistory();
+			p = -g * std::min(1.0, 1.0 / std::max(g.norm(), std::numeric_limits<double>::min()));
+		}
+
+		previous_x_ = x;
+		previous_g_ = g;
+		has_previous_iterate_ = true;
+	}
+
+	/**
+	 * Fields
+	 */
+
+	// L-BFGS settings
+	std::atomic<int64_t> history_length_;
+
+	// Circular history of the latest pairs, along with their 1 / (s.y) and the two-loop recursion coefficients
+	std::vector<Eigen::VectorXd> s_history_;
+	std::vector<Eigen::VectorXd> y_history_;
+	std::vector<double> rho_history_;
+	std::vector<double> alpha_;
+	int64_t pairs_count_;
+	int64_t latest_pair_index_;
+
+	// Previous iterate and gradient
+	Eigen::VectorXd previous_x_;
+	Eigen::VectorXd previous_g_;
+	bool has_previous_iterate_;
+
+	// Definition version of the objective function the history was collected for
+	std::size_t objective_function_definition_version_;
+};
+
+#endif
@@ -0,0 +1,143 @@
+#pragma once
+#ifndef OPTIMIZATION_LIB_NEWTON_CG_METHOD_H
+#define OPTIMIZATION_LIB_NEWTON_CG_METHOD_H
+
+// STL includes
+#include <memory>
+#include <algorithm>
+#include <cmath>
+
+// Eigen includes
+#include <Eigen/Core>
+
+// Optimization lib includes
+#include "./iterative_method.h"
+
+// Matrix-free (truncated) Newton method. The newton system is solved inexactly by a Jacobi-preconditioned conjugate gradient,
+// which only requires hessian-vector products of the objective function, so the global hessian is never assembled nor factorized.
+// https://en.wikipedia.org/wiki/Truncated_Newton_method
+template <Eigen::StorageOptions StorageOrder_>
+class NewtonCGMethod : public IterativeMethod<StorageOrder_>
+{
+public:
+	NewtonCGMethod(std::shared_ptr<ObjectiveFunction<StorageOrder_, Eigen::VectorXd>> objective_function, const Eigen::VectorXd& x0) :
+		IterativeMethod(objective_function, x0),
+		max_cg_iterations_(200),
+		max_forcing_term_(0.5)
+	{
+
+	}
+
+	virtual ~NewtonCGMethod()
+	{
+
+	}
+
+	/**
+	 * Getters
+	 */
+	int64_t GetMaxCGIterations() const
+	{
+		return max_cg_iterations_;
+	}
+
+	double GetMaxForcingTerm() const
+	{
+		return max_forcing_term_;
+	}
+
+	/**
+	 * Setters
+	 */
+	void SetMaxCGIterations(const int64_t max_cg_iterations)
+	{
+		max_cg_iterations_ = max_cg_iterations;
+	}
+
+	void SetMaxForcingTerm(const double max_forcing_term)
+	{
+		max_forcing_term_ = max_forcing_term;
+	}
+
+private:
+	void ComputeDescentDirection(Eigen::VectorXd& p) override
+	{
+		auto objective_function = this->GetObjectiveFunction();
+		const Eigen::VectorXd& g = objective_function->GetGradient();
+		const int64_t variables_count = g.rows();
+
+		/**
+		 * Jacobi preconditioner
+		 */
+		diagonal_.setZero(variables_count);
+		objective_function->AddHessianDiagonal(diagonal_);
+		inverse_diagonal_.resize(variables_count);
+		for (int64_t i = 0; i < variables_count; i++)
+		{
+			inverse_diagonal_.coeffRef(i) = diagonal_.coeff(i) > 0 ? 1.0 / diagonal_.coeff(i) : 1.0;
+		}
+
+		/**
+		 * Forcing term (superlinear choice, see Nocedal & Wright, Numerical Optimization, Section 7.1)
+		 */
+		const double g_norm = g.norm();
+		const double forcing_term = std::min(max_forcing_term_, std::sqrt(g_norm));
+		const double tolerance = forcing_term * g_norm;
+
+		/**
+		 * Preconditioned conjugate gradient on H * p = -g, starting from p = 0
+		 */
+		p.setZero(variables_count);
+		r_ = -g;
+		z_ = inverse_diagonal_.cwiseProduct(r_);
+		d_ = z_;
+		double rz = r_.dot(z_);
+		for (int64_t iteration = 0; iteration < max_cg_iterations_; iteration++)
+		{
+			Hd_.setZero(variables_count);
+			objective_function->AddHessianVectorProduct(d_, Hd_);
+			const double dHd = d_.dot(Hd_);
+
+			// Negative (or zero) curvature: fall back to the steepest descent direction on the first iteration, otherwise keep the current iterate
+			if (dHd <= 0)
+			{
+				if (iteration == 0)
+				{
+					p = -g;
+				}
+				break;
+			}
+
+			const double alpha = rz / dHd;
+			p += alpha * d_;
+			r_ -= alpha * Hd_;
+			if (r_.norm() <= tolerance)
+			{
+				break;
+			}
+
+			z_ = inverse_diagonal_.cwiseProduct(r_);
+			const double rz_next = r_.dot(z_);
+			d_ = z_ + (rz_next / rz) * d_;
+			rz = rz_next;
+		}
+	}
+
+	/**
+	 * Fields
+	 */
+
+	// Conjugate gradient settings
+	int64_t max_cg_iterations_;
+	double max_forcing_term_;
+
+	// Conjugate gradient buffers
+	Eigen::VectorXd diagonal_;
+	Eigen::VectorXd inverse_diagonal_;
+	Eigen::VectorXd r_;
+	Eigen::VectorXd z_;
+	Eigen::VectorXd d_;
+	Eigen::VectorXd Hd_;
+};
+
+#endif
\ No newline at end of file
@@ -17,12 +17,23 @@
 #include "../solvers/solver.h"
 
 // https://en.wikipedia.org/wiki/Newton%27s_method_in_optimization
+// Optionally, the numerical factorization of the hessian can be lagged: it is kept for up to max_hessian_lag iterations, which only update the
+// gradient, and is recomputed (together with the hessian) once the line search step achieves less than refactorization_threshold of the decrease
+// predicted by the quadratic model of the factorized hessian.
 template <class Derived, Eigen::StorageOptions StorageOrder_>
 class NewtonMethod : public IterativeMethod<StorageOrder_>
 {
 public:
 	NewtonMethod(std::shared_ptr<ObjectiveFunction<StorageOrder_, Eigen::VectorXd>> objective_function, const Eigen::VectorXd& x0) :
-		IterativeMethod(objective_function, x0)
+		IterativeMethod(objective_function, x0),
+		hessian_pattern_version_(0),
+		factorized_definition_version_(0),
+		max_hessian_lag_(0),
+		refactorization_threshold_(0.25),
+		lagged_iterations_count_(0),
+		directional_derivative_(0),
+		reuse_factorization_(false),
+		is_factorization_kept_(false)
 	{
 		InitializeSolver();
 	}
@@ -32,18 +43,126 @@ public:
 
 	}
 
+	/**
+	 * Getters
+	 */
+	int64_t GetMaxHessianLag() const
+	{
+		return max_hessian_lag_;
+	}
+
+	double GetRefactorizationThreshold() const
+	{
+		return refactorization_threshold_;
+	}
+
+	/**
+	 * Setters
+	 */
+
+	// A lag of zero refactorizes the hessian on every iteration
+	void SetMaxHessianLag(const int64_t max_hessian_lag)
+	{
+		max_hessian_lag_ = max_hessian_lag;
+	}
+
+	void SetRefactorizationThreshold(const double refactorization_threshold)
+	{
+		refactorization_threshold_ = refactorization_threshold;
+	}
+
+protected:
+	void ObjectiveFunctionChanged() override
+	{
+		InitializeSolver();
+	}
+
+	ObjectiveFunctionBase::UpdateOptions GetIterationUpdateOptions() const override
+	{
+		return IsFactorizationReusable() ? ObjectiveFunctionBase::UpdateOptions::Gradient : ObjectiveFunctionBase::UpdateOptions::Gradient | ObjectiveFunctionBase::UpdateOptions::Hessian;
+	}
+
+	void StepTaken(const Eigen::VectorXd& p, const double step_size, const double previous_value, const double value) override
+	{
+		// Since the factorized hessian H satisfies H * p = -g, the quadratic model predicts a decrease of -(g.p) * t * (1 - t / 2) for a step of size t along p
+		const double predicted_decrease = -directional_derivative_ * step_size * (1 - step_size / 2);
+		const bool is_model_accurate = (directional_derivative_ < 0) && (previous_value - value >= refactorization_threshold_ * predicted_decrease);
+		reuse_factorization_ = is_model_accurate && (lagged_iterations_count_ < max_hessian_lag_);
+	}
+
 private:
+	// A lagged factorization is reused only if the solver kept its own copy of the factorized values (so reassembling or rebuilding the hessian
+	// in between does not affect it), and only as long as the objective function it was computed for is unchanged
+	bool IsFactorizationReusable() const
+	{
+		auto objective_function = this->GetObjectiveFunction();
+		return
+			reuse_factorization_ &&
+			is_factorization_kept_ &&
+			objective_function->GetHessianPatternVersion() == hessian_pattern_version_ &&
+			objective_function->GetDefinitionVersion() == factorized_definition_version_;
+	}
+
 	void InitializeSolver()
 	{
-		solver_.AnalyzePattern(this->GetObjectiveFunction()->GetHessian());
+		auto objective_function = this->GetObjectiveFunction();
+		solver_.AnalyzePattern(objective_function->GetHessian());
+		hessian_pattern_version_ = objective_function->GetHessianPatternVersion();
+		reuse_factorization_ = false;
 	}
 	
 	void ComputeDescentDirection(Eigen::VectorXd& p) override
 	{
 		auto objective_function = this->GetObjectiveFunction();
-		solver_.Solve(objective_function->GetHessian(), -objective_function->GetGradient(), p);
+		const auto& g = objective_function->GetGradient();
+		if (IsFactorizationReusable())
+		{
+			lagged_iterations_count_++;
+		}
+		else
+		{
+			const auto& H = objective_function->GetHessian();
+
+			// The hessian pattern is rebuilt when objectives are added or removed. Solvers are expected to reuse the symbolic analysis of a previously seen pattern.
+			if (objective_function->GetHessianPatternVersion() != hessian_pattern_version_)
+			{
+				solver_.AnalyzePattern(H);
+				hessian_pattern_version_ = objective_function->GetHessianPatternVersion();
+			}
+
+			// The factorized values are copied only when lagging is enabled, since otherwise the factorization is solved with right away
+			is_factorization_kept_ = max_hessian_lag_ > 0;
+			solver_.SetKeepFactorizedValues(is_factorization_kept_);
+			solver_.Factorize(H);
+			factorized_definition_version_ = objective_function->GetDefinitionVersion();
+			lagged_iterations_count_ = 0;
+		}
+
+		solver_.Solve(-g, p);
+		directional_derivative_ = g.dot(p);
 	}
 
+	/**
+	 * Fields
+	 */
+
+	// Symbolic analysis
+	std::size_t hessian_pattern_version_;
+
+	// Definition version of the objective function at the latest factorization
+	std::size_t factorized_definition_version_;
+
+	// Hessian lagging settings
+	std::atomic<int64_t> max_hessian_lag_;
+	std::atomic<double> refactorization_threshold_;
+
+	// Hessian lagging state
+	int64_t lagged_iterations_count_;
+	double directional_derivative_;
+	bool reuse_factorization_;
+	bool is_factorization_kept_;
+
+	// Solver
 	std::enable_if_t<std::is_base_of<Solver<StorageOrder_>, Derived>::value, Derived> solver_;
 };
 
@@ -0,0 +1,960 @@
+#pragma once
+#ifndef OPTIMIZATION_LIB_BATCHED_SEAMLESS_OBJECTIVE_H
+#define OPTIMIZATION_LIB_BATCHED_SEAMLESS_OBJECTIVE_H
+
+// C includes
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+// STL includes
+#include <vector>
+#include <cmath>
+#include <mutex>
+#include <algorithm>
+
+// Eigen includes
+#include <Eigen/Core>
+#include <Eigen/Dense>
+#include <Eigen/Eigenvalues>
+
+// TBB includes
+#include <tbb/parallel_for.h>
+
+// Optimization lib includes
+#include "../core/core.h"
+#include "../data_providers/empty_data_provider.h"
+#include "../data_providers/edge_pair_data_provider.h"
+#include "./dense_objective_function.h"
+#include "./periodic_objective.h"
+
+// Evaluates the same terms as SeamlessObjective (a periodic edge pair angle term, an edge pair length term and an integer translation term per edge pair),
+// but stores all edge pairs in structure-of-arrays form and evaluates them in batched loops, instead of composing ~10 objective and data provider objects per edge pair.
+template <Eigen::StorageOptions StorageOrder_>
+class BatchedSeamlessObjective : public DenseObjectiveFunction<StorageOrder_>
+{
+public:
+	/**
+	 * Public type definitions
+	 */
+	enum class Properties : int32_t
+	{
+		Zeta = DenseObjectiveFunction<StorageOrder_>::Properties::Count_,
+		AngleValuePerEdge,
+		LengthValuePerEdge,
+		EdgeAngleWeight,
+		EdgeLengthWeight,
+
+		AngleWeight,
+		LengthWeight,
+		TranslationWeight,
+
+		Interval,
+
+		EdgeAngleWeights,
+		EdgeLengthWeights
+	};
+
+	/**
+	 * Constructors and destructor
+	 */
+	BatchedSeamlessObjective(const std::shared_ptr<MeshDataProvider>& mesh_data_provider, const std::shared_ptr<EmptyDataProvider>& empty_data_provider, const std::string& name, const bool enforce_children_psd = true) :
+		DenseObjectiveFunction(mesh_data_provider, empty_data_provider, name, 0, false),
+		enforce_children_psd_(enforce_children_psd),
+		zeta_(1),
+		angle_weight_(0),
+		length_weight_(0),
+		translation_weight_(0)
+	{
+		PeriodicObjective<StorageOrder_>::CalculatePolynomialCoeffs(M_PI / 2, angle_polynomial_coeffs_);
+		SetInterval(1);
+	}
+
+	BatchedSeamlessObjective(const std::shared_ptr<MeshDataProvider>& mesh_data_provider, const std::shared_ptr<EmptyDataProvider>& empty_data_provider, const bool enforce_children_psd = true) :
+		BatchedSeamlessObjective(mesh_data_provider, empty_data_provider, "Seamless", enforce_children_psd)
+	{
+
+	}
+
+	virtual ~BatchedSeamlessObjective()
+	{
+
+	}
+
+	/**
+	 * Setters
+	 */
+	void SetInterval(const double interval)
+	{
+		interval_ = interval;
+		PeriodicObjective<StorageOrder_>::CalculatePolynomialCoeffs(interval_, translation_polynomial_coeffs_);
+	}
+
+	void SetZeta(const double zeta)
+	{
+		// Empty implementation (disabled, as in SeamlessObjective)
+	}
+
+	// The edge angle weight scales the periodic angle term of its edge pair (on top of the angle weight)
+	void SetEdgeAngleWeight(const RDS::EdgeIndex edge_index, const double weight)
+	{
+		const int64_t edge_pair_index = GetEdgePairIndex(edge_index);
+		if (edge_pair_index >= 0)
+		{
+			edge_angle_weights_[edge_pair_index] = weight;
+		}
+	}
+
+	void SetEdgeLengthWeight(const RDS::EdgeIndex edge_index, const double weight)
+	{
+		const int64_t edge_pair_index = GetEdgePairIndex(edge_index);
+		if (edge_pair_index >= 0)
+		{
+			edge_length_weights_[edge_pair_index] = weight;
+		}
+	}
+
+	// Sets the angle weights of all edge pairs at once, from a vector indexed by domain edge index
+	void SetEdgeAngleWeights(const Eigen::VectorXd& edge_angle_weights)
+	{
+		if (!HasWeightPerDomainEdge(edge_angle_weights))
+		{
+			throw std::exception("Expected an angle weight per domain edge");
+		}
+
+		const int64_t edge_pairs_count = domain_edge_indices_.size();
+		for (int64_t i = 0; i < edge_pairs_count; i++)
+		{
+			edge_angle_weights_[i] = edge_angle_weights.coeff(domain_edge_indices_[i]);
+		}
+	}
+
+	// Sets the length weights of all edge pairs at once, from a vector indexed by domain edge index
+	void SetEdgeLengthWeights(const Eigen::VectorXd& edge_length_weights)
+	{
+		if (!HasWeightPerDomainEdge(edge_length_weights))
+		{
+			throw std::exception("Expected a length weight per domain edge");
+		}
+
+		const int64_t edge_pairs_count = domain_edge_indices_.size();
+		for (int64_t i = 0; i < edge_pairs_count; i++)
+		{
+			edge_length_weights_[i] = edge_length_weights.coeff(domain_edge_indices_[i]);
+		}
+	}
+
+	void SetAngleWeight(const double weight)
+	{
+		angle_weight_ = weight;
+	}
+
+	void SetLengthWeight(const double weight)
+	{
+		length_weight_ = weight;
+		std::fill(edge_length_weights_.begin(), edge_length_weights_.end(), weight);
+	}
+
+	void SetTranslationWeight(const double weight)
+	{
+		translation_weight_ = weight;
+	}
+
+	bool SetProperty(const int32_t property_id, const std::any property_context, const std::any property_value) override
+	{
+		if (DenseObjectiveFunction<StorageOrder_>::SetProperty(property_id, property_context, property_value))
+		{
+			return true;
+		}
+
+		const Properties properties = static_cast<Properties>(property_id);
+		switch (properties)
+		{
+		case Properties::Zeta:
+			SetZeta(std::any_cast<const double>(property_value));
+			return true;
+		case Properties::EdgeAngleWeight:
+			SetEdgeAngleWeight(static_cast<RDS::EdgeIndex>(std::any_cast<double>(property_context)), std::any_cast<const double>(property_value));
+			return true;
+		case Properties::EdgeLengthWeight:
+			SetEdgeLengthWeight(static_cast<RDS::EdgeIndex>(std::any_cast<double>(property_context)), std::any_cast<const double>(property_value));
+			return true;
+		case Properties::AngleWeight:
+			SetAngleWeight(std::any_cast<const double>(property_value));
+			return true;
+		case Properties::LengthWeight:
+			SetLengthWeight(std::any_cast<const double>(property_value));
+			return true;
+		case Properties::TranslationWeight:
+			SetTranslationWeight(std::any_cast<const double>(property_value));
+			return true;
+		case Properties::Interval:
+			SetInterval(std::any_cast<const double>(property_value));
+			return true;
+		case Properties::EdgeAngleWeights:
+			SetEdgeAngleWeights(std::any_cast<const Eigen::VectorXd&>(property_value));
+			return true;
+		case Properties::EdgeLengthWeights:
+			SetEdgeLengthWeights(std::any_cast<const Eigen::VectorXd&>(property_value));
+			return true;
+		}
+
+		return false;
+	}
+
+	/**
+	 * Getters
+	 */
+	double GetZeta() const
+	{
+		return zeta_;
+	}
+
+	double GetInterval() const
+	{
+		return interval_;
+	}
+
+	std::size_t GetEdgePairsCount() const
+	{
+		return domain_edge_indices_.size();
+	}
+
+	// The angle and length values per edge are read from their published copies (see ObjectiveFunction::PublishDiagnostics())
+	const Eigen::VectorXd& GetAngleValuePerEdge(const ObjectiveFunctionBase::PropertyModifiers property_modifiers) const
+	{
+		switch (property_modifiers)
+		{
+		case ObjectiveFunctionBase::PropertyModifiers::Domain:
+			return GetDomainAngleValuePerEdge();
+		case ObjectiveFunctionBase::PropertyModifiers::Image:
+			return GetImageAngleValuePerEdge();
+		}
+	}
+
+	const Eigen::VectorXd& GetLengthValuePerEdge(const ObjectiveFunctionBase::PropertyModifiers property_modifiers) const
+	{
+		switch (property_modifiers)
+		{
+		case ObjectiveFunctionBase::PropertyModifiers::Domain:
+			return GetDomainLengthValuePerEdge();
+		case ObjectiveFunctionBase::PropertyModifiers::Image:
+			return GetImageLengthValuePerEdge();
+		}
+	}
+
+	const Eigen::VectorXd& GetImageAngleValuePerEdge() const
+	{
+		return published_image_angle_value_per_edge_;
+	}
+
+	const Eigen::VectorXd& GetImageLengthValuePerEdge() const
+	{
+		return published_image_length_value_per_edge_;
+	}
+
+	const Eigen::VectorXd& GetDomainAngleValuePerEdge() const
+	{
+		return published_domain_angle_value_per_edge_;
+	}
+
+	const Eigen::VectorXd& GetDomainLengthValuePerEdge() const
+	{
+		return published_domain_length_value_per_edge_;
+	}
+
+	double GetEdgeAngleWeight(const RDS::EdgeIndex edge_index) const
+	{
+		const int64_t edge_pair_index = GetEdgePairIndex(edge_index);
+		if (edge_pair_index >= 0)
+		{
+			return edge_angle_weights_[edge_pair_index];
+		}
+
+		return 0;
+	}
+
+	double GetEdgeLengthWeight(const RDS::EdgeIndex edge_index) const
+	{
+		const int64_t edge_pair_index = GetEdgePairIndex(edge_index);
+		if (edge_pair_index >= 0)
+		{
+			return edge_length_weights_[edge_pair_index];
+		}
+
+		return 0;
+	}
+
+	double GetAngleWeight() const
+	{
+		return angle_weight_;
+	}
+
+	double GetLengthWeight() const
+	{
+		return length_weight_;
+	}
+
+	double GetTranslationWeight() const
+	{
+		return translation_weight_;
+	}
+
+	bool GetProperty(const int32_t property_id, const int32_t property_modifier_id, const std::any property_context, std::any& property_value) override
+	{
+		if (DenseObjectiveFunction<StorageOrder_>::GetProperty(property_id, property_modifier_id, property_context, property_value))
+		{
+			return true;
+		}
+
+		const ObjectiveFunctionBase::PropertyModifiers property_modifiers = static_cast<ObjectiveFunctionBase::PropertyModifiers>(property_modifier_id);
+		const Properties properties = static_cast<Properties>(property_id);
+		switch (properties)
+		{
+		case Properties::Zeta:
+			property_value = GetZeta();
+			return true;
+		case Properties::AngleValuePerEdge:
+		{
+			const auto lock = this->LockPublishedValuePerEdge();
+			property_value = GetAngleValuePerEdge(property_modifiers);
+			return true;
+		}
+		case Properties::LengthValuePerEdge:
+		{
+			const auto lock = this->LockPublishedValuePerEdge();
+			property_value = GetLengthValuePerEdge(property_modifiers);
+			return true;
+		}
+		case Properties::EdgeAngleWeight:
+			property_value = GetEdgeAngleWeight(static_cast<RDS::EdgeIndex>(std::any_cast<double>(property_context)));
+			return true;
+		case Properties::EdgeLengthWeight:
+			property_value = GetEdgeLengthWeight(static_cast<RDS::EdgeIndex>(std::any_cast<double>(property_context)));
+			return true;
+		case Properties::AngleWeight:
+			property_value = GetAngleWeight();
+			return true;
+		case Properties::LengthWeight:
+			property_value = GetLengthWeight();
+			return true;
+		case Properties::TranslationWeight:
+			property_value = GetTranslationWeight();
+			return true;
+		}
+
+		return false;
+	}
+
+	/**
+	 * Public methods
+	 */
+
+	// Adds an edge pair. Thread safe; Initialize() must be called once all edge pairs were added (as done for SeamlessObjective).
+	void AddEdgePair(const RDS::EdgePairDescriptor& edge_pair_descriptor)
+	{
+		AddEdgePair(
+			edge_pair_descriptor.first.first,
+			edge_pair_descriptor.first.second,
+			edge_pair_descriptor.second.first,
+			edge_pair_descriptor.second.second,
+			this->mesh_data_provider_->GetDomainEdgeIndex(edge_pair_descriptor.first),
+			this->mesh_data_provider_->GetImageEdgeIndex(edge_pair_descriptor.first),
+			this->mesh_data_provider_->GetImageEdgeIndex(edge_pair_descriptor.second));
+	}
+
+	// Drop-in replacement for SeamlessObjective::AddEdgePairObjectives(). Only the indices of the data provider are used.
+	void AddEdgePairObjectives(const std::shared_ptr<EdgePairDataProvider>& edge_pair_data_provider)
+	{
+		AddEdgePair(
+			edge_pair_data_provider->GetEdge1Vertex1Index(),
+			edge_pair_data_provider->GetEdge1Vertex2Index(),
+			edge_pair_data_provider->GetEdge2Vertex1Index(),
+			edge_pair_data_provider->GetEdge2Vertex2Index(),
+			edge_pair_data_provider->GetDomainEdgeIndex(),
+			edge_pair_data_provider->GetImageEdge1Index(),
+			edge_pair_data_provider->GetImageEdge2Index());
+	}
+
+protected:
+	/**
+	 * Protected overrides
+	 */
+	void PostInitialize() override
+	{
+		DenseObjectiveFunction<StorageOrder_>::PostInitialize();
+		image_angle_value_per_edge_.resize(this->mesh_data_provider_->GetImageEdgesCount());
+		image_length_value_per_edge_.resize(this->mesh_data_provider_->GetImageEdgesCount());
+		domain_angle_value_per_edge_.resize(this->mesh_data_provider_->GetDomainEdgesCount());
+		domain_length_value_per_edge_.resize(this->mesh_data_provider_->GetDomainEdgesCount());
+		published_image_angle_value_per_edge_.setZero(this->mesh_data_provider_->GetImageEdgesCount());
+		published_image_length_value_per_edge_.setZero(this->mesh_data_provider_->GetImageEdgesCount());
+		published_domain_angle_value_per_edge_.setZero(this->mesh_data_provider_->GetDomainEdgesCount());
+		published_domain_length_value_per_edge_.setZero(this->mesh_data_provider_->GetDomainEdgesCount());
+
+		const std::size_t edge_pairs_count = domain_edge_indices_.size();
+		e1_x_.resize(edge_pairs_count);
+		e1_y_.resize(edge_pairs_count);
+		e2_x_.resize(edge_pairs_count);
+		e2_y_.resize(edge_pairs_count);
+		e1_squared_norms_.resize(edge_pairs_count);
+		e2_squared_norms_.resize(edge_pairs_count);
+		angle_values_.resize(edge_pairs_count);
+		angle_first_derivatives_.resize(edge_pairs_count);
+		angle_second_derivatives_.resize(edge_pairs_count);
+		squared_norm_diffs_.resize(edge_pairs_count);
+		translation_x_values_.resize(edge_pairs_count);
+		translation_x_first_derivatives_.resize(edge_pairs_count);
+		translation_x_second_derivatives_.resize(edge_pairs_count);
+		translation_y_values_.resize(edge_pairs_count);
+		translation_y_first_derivatives_.resize(edge_pairs_count);
+		translation_y_second_derivatives_.resize(edge_pairs_count);
+	}
+
+	void PublishValuePerEdge() override
+	{
+		DenseObjectiveFunction<StorageOrder_>::PublishValuePerEdge();
+		published_image_angle_value_per_edge_ = image_angle_value_per_edge_;
+		published_image_length_value_per_edge_ = image_length_value_per_edge_;
+		published_domain_angle_value_per_edge_ = domain_angle_value_per_edge_;
+		published_domain_length_value_per_edge_ = domain_length_value_per_edge_;
+	}
+
+	void PreUpdate(const Eigen::VectorXd& x) override
+	{
+		const int64_t edge_pairs_count = domain_edge_indices_.size();
+
+		/**
+		 * Gather edges and vertex differences
+		 */
+		for (int64_t i = 0; i < edge_pairs_count; i++)
+		{
+			e1_x_[i] = x.coeff(e1_v2_x_indices_[i]) - x.coeff(e1_v1_x_indices_[i]);
+			e1_y_[i] = x.coeff(e1_v2_y_indices_[i]) - x.coeff(e1_v1_y_indices_[i]);
+			e2_x_[i] = x.coeff(e2_v2_x_indices_[i]) - x.coeff(e2_v1_x_indices_[i]);
+			e2_y_[i] = x.coeff(e2_v2_y_indices_[i]) - x.coeff(e2_v1_y_indices_[i]);
+			translation_x_values_[i] = x.coeff(e1_v1_x_indices_[i]) - x.coeff(e2_v1_x_indices_[i]);
+			translation_y_values_[i] = x.coeff(e1_v1_y_indices_[i]) - x.coeff(e2_v1_y_indices_[i]);
+		}
+
+		/**
+		 * Edge norms and length term
+		 */
+		for (int64_t i = 0; i < edge_pairs_count; i++)
+		{
+			e1_squared_norms_[i] = e1_x_[i] * e1_x_[i] + e1_y_[i] * e1_y_[i];
+			e2_squared_norms_[i] = e2_x_[i] * e2_x_[i] + e2_y_[i] * e2_y_[i];
+			squared_norm_diffs_[i] = e1_squared_norms_[i] - e2_squared_norms_[i];
+		}
+
+		/**
+		 * Periodic angle and translation terms. Terms with zero weight are not evaluated (and their values are reported as zeros).
+		 */
+		const bool angle_active = angle_weight_ != 0;
+		const bool translation_active = translation_weight_ != 0;
+		if (!angle_active)
+		{
+			std::fill(angle_values_.begin(), angle_values_.end(), 0);
+			std::fill(angle_first_derivatives_.begin(), angle_first_derivatives_.end(), 0);
+			std::fill(angle_second_derivatives_.begin(), angle_second_derivatives_.end(), 0);
+		}
+
+		if (!translation_active)
+		{
+			std::fill(translation_x_values_.begin(), translation_x_values_.end(), 0);
+			std::fill(translation_x_first_derivatives_.begin(), translation_x_first_derivatives_.end(), 0);
+			std::fill(translation_x_second_derivatives_.begin(), translation_x_second_derivatives_.end(), 0);
+			std::fill(translation_y_values_.begin(), translation_y_values_.end(), 0);
+			std::fill(translation_y_first_derivatives_.begin(), translation_y_first_derivatives_.end(), 0);
+			std::fill(translation_y_second_derivatives_.begin(), translation_y_second_derivatives_.end(), 0);
+		}
+
+		if (!angle_active && !translation_active)
+		{
+			return;
+		}
+
+		tbb::parallel_for(static_cast<int64_t>(0), edge_pairs_count, [&](const int64_t i)
+		{
+			if (angle_active)
+			{
+				const double angle = std::atan2(e1_y_[i], e1_x_[i]) - std::atan2(e2_y_[i], e2_x_[i]) + M_PI;
+				PeriodicObjective<StorageOrder_>::CalculatePolynomialDerivatives(angle, M_PI / 2, angle_polynomial_coeffs_, angle_values_[i], angle_first_derivatives_[i], angle_second_derivatives_[i]);
+			}
+
+			if (translation_active)
+			{
+				PeriodicObjective<StorageOrder_>::CalculatePolynomialDerivatives(translation_x_values_[i], interval_, translation_polynomial_coeffs_, translation_x_values_[i], translation_x_first_derivatives_[i], translation_x_second_derivatives_[i]);
+				PeriodicObjective<StorageOrder_>::CalculatePolynomialDerivatives(translation_y_values_[i], interval_, translation_polynomial_coeffs_, translation_y_values_[i], translation_y_first_derivatives_[i], translation_y_second_derivatives_[i]);
+			}
+		});
+	}
+
+private:
+	/**
+	 * Private type definitions
+	 */
+
+	// Local variables of an edge pair are ordered as: e1_v1_x, e1_v1_y, e1_v2_x, e1_v2_y, e2_v1_x, e2_v1_y, e2_v2_x, e2_v2_y
+	using LocalGradient = Eigen::Matrix<double, 8, 1>;
+	using LocalHessian = Eigen::Matrix<double, 8, 8>;
+
+	// Upper triangle of the local 8x8 hessian (36 entries), followed by the upper triangles of the two 2x2 translation hessians (3 entries each)
+	static constexpr int64_t local_triplets_count_ = 42;
+	static constexpr int64_t translation_triplets_count_ = 6;
+
+	/**
+	 * Private overrides
+	 */
+	void InitializeTriplets(std::vector<Eigen::Triplet<double>>& triplets) override
+	{
+		const int64_t edge_pairs_count = domain_edge_indices_.size();
+		triplets.resize(local_triplets_count_ * edge_pairs_count);
+		for (int64_t i = 0; i < edge_pairs_count; i++)
+		{
+			const RDS::SparseVariableIndex local_indices[8] = {
+				e1_v1_x_indices_[i], e1_v1_y_indices_[i], e1_v2_x_indices_[i], e1_v2_y_indices_[i],
+				e2_v1_x_indices_[i], e2_v1_y_indices_[i], e2_v2_x_indices_[i], e2_v2_y_indices_[i] };
+
+			int64_t triplet_index = local_triplets_count_ * i;
+			for (int64_t column = 0; column < 8; column++)
+			{
+				for (int64_t row = 0; row <= column; row++)
+				{
+					triplets[triplet_index++] = CreateUpperTriplet(local_indices[row], local_indices[column]);
+				}
+			}
+
+			triplets[triplet_index++] = CreateUpperTriplet(e1_v1_x_indices_[i], e1_v1_x_indices_[i]);
+			triplets[triplet_index++] = CreateUpperTriplet(e1_v1_x_indices_[i], e2_v1_x_indices_[i]);
+			triplets[triplet_index++] = CreateUpperTriplet(e2_v1_x_indices_[i], e2_v1_x_indices_[i]);
+			triplets[triplet_index++] = CreateUpperTriplet(e1_v1_y_indices_[i], e1_v1_y_indices_[i]);
+			triplets[triplet_index++] = CreateUpperTriplet(e1_v1_y_indices_[i], e2_v1_y_indices_[i]);
+			triplets[triplet_index++] = CreateUpperTriplet(e2_v1_y_indices_[i], e2_v1_y_indices_[i]);
+		}
+	}
+
+	void CalculateValue(double& f) override
+	{
+		double angle_value = 0;
+		double length_value = 0;
+		double translation_value = 0;
+		const int64_t edge_pairs_count = domain_edge_indices_.size();
+		for (int64_t i = 0; i < edge_pairs_count; i++)
+		{
+			angle_value += edge_angle_weights_[i] * angle_values_[i];
+			length_value += edge_length_weights_[i] * squared_norm_diffs_[i] * squared_norm_diffs_[i];
+			translation_value += translation_x_values_[i] + translation_y_values_[i];
+		}
+
+		f = angle_weight_ * angle_value + length_value + translation_weight_ * translation_value;
+	}
+
+	void CalculateValuePerVertex(Eigen::VectorXd& f_per_vertex) override
+	{
+		// Each objective of SeamlessObjective adds its value once per variable (twice per vertex) of its own variables
+		f_per_vertex.setZero();
+		const int64_t edge_pairs_count = domain_edge_indices_.size();
+		for (int64_t i = 0; i < edge_pairs_count; i++)
+		{
+			const double edge_pair_value = 2 * (angle_weight_ * edge_angle_weights_[i] * angle_values_[i] + edge_length_weights_[i] * squared_norm_diffs_[i] * squared_norm_diffs_[i]);
+			const double translation_value = translation_weight_ * (translation_x_values_[i] + translation_y_values_[i]);
+			f_per_vertex.coeffRef(e1_v1_indices_[i]) += edge_pair_value + translation_value;
+			f_per_vertex.coeffRef(e1_v2_indices_[i]) += edge_pair_value;
+			f_per_vertex.coeffRef(e2_v1_indices_[i]) += edge_pair_value + translation_value;
+			f_per_vertex.coeffRef(e2_v2_indices_[i]) += edge_pair_value;
+		}
+	}
+
+	void CalculateValuePerEdge(Eigen::VectorXd& domain_value_per_edge, Eigen::VectorXd& image_value_per_edge) override
+	{
+		domain_angle_value_per_edge_.setZero();
+		image_angle_value_per_edge_.setZero();
+		domain_length_value_per_edge_.setZero();
+		image_length_value_per_edge_.setZero();
+		const int64_t edge_pairs_count = domain_edge_indices_.size();
+		for (int64_t i = 0; i < edge_pairs_count; i++)
+		{
+			const double angle_value = angle_values_[i];
+			domain_angle_value_per_edge_.coeffRef(domain_edge_indices_[i]) += angle_value;
+			image_angle_value_per_edge_.coeffRef(image_edge_1_indices_[i]) += angle_value;
+			image_angle_value_per_edge_.coeffRef(image_edge_2_indices_[i]) += angle_value;
+
+			const double length_value = squared_norm_diffs_[i] * squared_norm_diffs_[i];
+			domain_length_value_per_edge_.coeffRef(domain_edge_indices_[i]) += length_value;
+			image_length_value_per_edge_.coeffRef(image_edge_1_indices_[i]) += length_value;
+			image_length_value_per_edge_.coeffRef(image_edge_2_indices_[i]) += length_value;
+		}
+
+		domain_value_per_edge = domain_angle_value_per_edge_ + domain_length_value_per_edge_;
+		image_value_per_edge = image_angle_value_per_edge_ + image_length_value_per_edge_;
+	}
+
+	void CalculateGradient(Eigen::VectorXd& g) override
+	{
+		g.setZero();
+		LocalGradient local_g;
+		const int64_t edge_pairs_count = domain_edge_indices_.size();
+		const bool translation_active = translation_weight_ != 0;
+		for (int64_t i = 0; i < edge_pairs_count; i++)
+		{
+			if (IsEdgePairActive(i))
+			{
+				CalculateLocalGradient(i, local_g);
+				g.coeffRef(e1_v1_x_indices_[i]) += local_g.coeff(0);
+				g.coeffRef(e1_v1_y_indices_[i]) += local_g.coeff(1);
+				g.coeffRef(e1_v2_x_indices_[i]) += local_g.coeff(2);
+				g.coeffRef(e1_v2_y_indices_[i]) += local_g.coeff(3);
+				g.coeffRef(e2_v1_x_indices_[i]) += local_g.coeff(4);
+				g.coeffRef(e2_v1_y_indices_[i]) += local_g.coeff(5);
+				g.coeffRef(e2_v2_x_indices_[i]) += local_g.coeff(6);
+				g.coeffRef(e2_v2_y_indices_[i]) += local_g.coeff(7);
+			}
+
+			if (translation_active)
+			{
+				const double translation_x_derivative = translation_weight_ * translation_x_first_derivatives_[i];
+				const double translation_y_derivative = translation_weight_ * translation_y_first_derivatives_[i];
+				g.coeffRef(e1_v1_x_indices_[i]) += translation_x_derivative;
+				g.coeffRef(e2_v1_x_indices_[i]) -= translation_x_derivative;
+				g.coeffRef(e1_v1_y_indices_[i]) += translation_y_derivative;
+				g.coeffRef(e2_v1_y_indices_[i]) -= translation_y_derivative;
+			}
+		}
+	}
+
+	void CalculateRawTriplets(std::vector<Eigen::Triplet<double>>& triplets) override
+	{
+		// Entries of zero-weight terms are kept in the hessian pattern as explicit zeros (so weight changes never change the pattern), and are not calculated
+		const int64_t edge_pairs_count = domain_edge_indices_.size();
+		const bool translation_active = translation_weight_ != 0;
+		tbb::parallel_for(static_cast<int64_t>(0), edge_pairs_count, [&](const int64_t i)
+		{
+			int64_t triplet_index = local_triplets_count_ * i;
+			if (IsEdgePairActive(i))
+			{
+				LocalHessian angle_H;
+				const double edge_angle_weight = angle_weight_ * edge_angle_weights_[i];
+				if (edge_angle_weight != 0)
+				{
+					LocalGradient angle_g;
+					CalculateLocalAngleGradient(i, angle_g);
+					CalculateLocalAngleHessian(i, angle_H);
+
+					// Hessian of the periodic angle term: f'(u) * H_angle + f''(u) * g_angle * g_angle^T
+					angle_H = angle_first_derivatives_[i] * angle_H + angle_second_derivatives_[i] * angle_g * angle_g.transpose();
+					if (enforce_children_psd_)
+					{
+						ProjectToPsd(angle_H);
+					}
+				}
+				else
+				{
+					angle_H.setZero();
+				}
+
+				LocalHessian length_H;
+				const double edge_length_weight = edge_length_weights_[i];
+				if (edge_length_weight != 0)
+				{
+					CalculateLocalLengthHessian(i, length_H);
+				}
+				else
+				{
+					length_H.setZero();
+				}
+
+				for (int64_t column = 0; column < 8; column++)
+				{
+					for (int64_t row = 0; row <= column; row++)
+					{
+						const_cast<double&>(triplets[triplet_index++].value()) = edge_angle_weight * angle_H.coeff(row, column) + edge_length_weight * length_H.coeff(row, column);
+					}
+				}
+			}
+			else
+			{
+				for (int64_t j = 0; j < local_triplets_count_ - translation_triplets_count_; j++)
+				{
+					const_cast<double&>(triplets[triplet_index++].value()) = 0;
+				}
+			}
+
+			// The periodic translation terms are compositions of linear functions (whose gradient is g = (1, -1)), so their hessian is f''(u) * g * g^T.
+			// When it is negative, its single nonzero eigenvalue (2 * f''(u)) is clamped to 10e-8.
+			const double translation_x_coefficient = translation_active ? translation_weight_ * CalculateTranslationHessianCoefficient(translation_x_second_derivatives_[i]) : 0;
+			const double translation_y_coefficient = translation_active ? translation_weight_ * CalculateTranslationHessianCoefficient(translation_y_second_derivatives_[i]) : 0;
+			const_cast<double&>(triplets[triplet_index++].value()) = translation_x_coefficient;
+			const_cast<double&>(triplets[triplet_index++].value()) = -translation_x_coefficient;
+			const_cast<double&>(triplets[triplet_index++].value()) = translation_x_coefficient;
+			const_cast<double&>(triplets[triplet_index++].value()) = translation_y_coefficient;
+			const_cast<double&>(triplets[triplet_index++].value()) = -translation_y_coefficient;
+			const_cast<double&>(triplets[triplet_index++].value()) = translation_y_coefficient;
+		});
+	}
+
+	/**
+	 * Private methods
+	 */
+	void AddEdgePair(
+		const RDS::VertexIndex e1_v1_index,
+		const RDS::VertexIndex e1_v2_index,
+		const RDS::VertexIndex e2_v1_index,
+		const RDS::VertexIndex e2_v2_index,
+		const RDS::EdgeIndex domain_edge_index,
+		const RDS::EdgeIndex image_edge_1_index,
+		const RDS::EdgeIndex image_edge_2_index)
+	{
+		std::lock_guard<std::mutex> lock(this->m_);
+
+		e1_v1_indices_.push_back(e1_v1_index);
+		e1_v2_indices_.push_back(e1_v2_index);
+		e2_v1_indices_.push_back(e2_v1_index);
+		e2_v2_indices_.push_back(e2_v2_index);
+
+		e1_v1_x_indices_.push_back(this->mesh_data_provider_->GetXVariableIndex(e1_v1_index));
+		e1_v1_y_indices_.push_back(this->mesh_data_provider_->GetYVariableIndex(e1_v1_index));
+		e1_v2_x_indices_.push_back(this->mesh_data_provider_->GetXVariableIndex(e1_v2_index));
+		e1_v2_y_indices_.push_back(this->mesh_data_provider_->GetYVariableIndex(e1_v2_index));
+		e2_v1_x_indices_.push_back(this->mesh_data_provider_->GetXVariableIndex(e2_v1_index));
+		e2_v1_y_indices_.push_back(this->mesh_data_provider_->GetYVariableIndex(e2_v1_index));
+		e2_v2_x_indices_.push_back(this->mesh_data_provider_->GetXVariableIndex(e2_v2_index));
+		e2_v2_y_indices_.push_back(this->mesh_data_provider_->GetYVariableIndex(e2_v2_index));
+
+		if (static_cast<std::size_t>(domain_edge_index) >= domain_edge_to_edge_pair_index_.size())
+		{
+			domain_edge_to_edge_pair_index_.resize(std::max(static_cast<std::size_t>(domain_edge_index) + 1, static_cast<std::size_t>(this->mesh_data_provider_->GetDomainEdgesCount())), -1);
+		}
+		domain_edge_to_edge_pair_index_[domain_edge_index] = domain_edge_indices_.size();
+
+		domain_edge_indices_.push_back(domain_edge_index);
+		image_edge_1_indices_.push_back(image_edge_1_index);
+		image_edge_2_indices_.push_back(image_edge_2_index);
+
+		edge_angle_weights_.push_back(1);
+		edge_length_weights_.push_back(length_weight_);
+	}
+
+	// Index of the edge pair of a domain edge, or -1 if the domain edge is not a seam edge
+	int64_t GetEdgePairIndex(const RDS::EdgeIndex domain_edge_index) const
+	{
+		if (domain_edge_index < 0 || static_cast<std::size_t>(domain_edge_index) >= domain_edge_to_edge_pair_index_.size())
+		{
+			return -1;
+		}
+
+		return domain_edge_to_edge_pair_index_[domain_edge_index];
+	}
+
+	// Bulk per-edge weights are indexed by domain edge index, so they must hold a weight for every domain edge
+	bool HasWeightPerDomainEdge(const Eigen::VectorXd& edge_weights) const
+	{
+		return edge_weights.rows() == this->mesh_data_provider_->GetDomainEdgesCount();
+	}
+
+	// The angle and length terms of an edge pair share their hessian block, which is active unless both are weighted by zero
+	bool IsEdgePairActive(const int64_t edge_pair_index) const
+	{
+		return angle_weight_ * edge_angle_weights_[edge_pair_index] != 0 || edge_length_weights_[edge_pair_index] != 0;
+	}
+
+	static Eigen::Triplet<double> CreateUpperTriplet(const RDS::SparseVariableIndex index1, const RDS::SparseVariableIndex index2)
+	{
+		return index1 <= index2 ? Eigen::Triplet<double>(index1, index2, 0) : Eigen::Triplet<double>(index2, index1, 0);
+	}
+
+	// Weighted gradient of the periodic angle and length terms of an edge pair, with respect to its local variables
+	void CalculateLocalGradient(const int64_t edge_pair_index, LocalGradient& local_g) const
+	{
+		const double e1_x = e1_x_[edge_pair_index];
+		const double e1_y = e1_y_[edge_pair_index];
+		const double e2_x = e2_x_[edge_pair_index];
+		const double e2_y = e2_y_[edge_pair_index];
+		const double s = edge_length_weights_[edge_pair_index] * 4 * squared_norm_diffs_[edge_pair_index];
+		const double edge_angle_weight = angle_weight_ * edge_angle_weights_[edge_pair_index];
+
+		if (edge_angle_weight != 0)
+		{
+			LocalGradient angle_g;
+			CalculateLocalAngleGradient(edge_pair_index, angle_g);
+			local_g = (edge_angle_weight * angle_first_derivatives_[edge_pair_index]) * angle_g;
+		}
+		else
+		{
+			local_g.setZero();
+		}
+
+		local_g.coeffRef(0) -= s * e1_x;
+		local_g.coeffRef(1) -= s * e1_y;
+		local_g.coeffRef(2) += s * e1_x;
+		local_g.coeffRef(3) += s * e1_y;
+		local_g.coeffRef(4) += s * e2_x;
+		local_g.coeffRef(5) += s * e2_y;
+		local_g.coeffRef(6) -= s * e2_x;
+		local_g.coeffRef(7) -= s * e2_y;
+	}
+
+	// Gradient of the (inner) edge pair angle, atan2(e1) - atan2(e2) + pi, where e = v2 - v1
+	void CalculateLocalAngleGradient(const int64_t edge_pair_index, LocalGradient& angle_g) const
+	{
+		const double a1 = e1_y_[edge_pair_index] / e1_squared_norms_[edge_pair_index];
+		const double b1 = e1_x_[edge_pair_index] / e1_squared_norms_[edge_pair_index];
+		const double a2 = e2_y_[edge_pair_index] / e2_squared_norms_[edge_pair_index];
+		const double b2 = e2_x_[edge_pair_index] / e2_squared_norms_[edge_pair_index];
+		angle_g << a1, -b1, -a1, b1, -a2, b2, a2, -b2;
+	}
+
+	// Hessian of the (inner) edge pair angle
+	void CalculateLocalAngleHessian(const int64_t edge_pair_index, LocalHessian& angle_H) const
+	{
+		const double e1_x = e1_x_[edge_pair_index];
+		const double e1_y = e1_y_[edge_pair_index];
+		const double e2_x = e2_x_[edge_pair_index];
+		const double e2_y = e2_y_[edge_pair_index];
+		const double e1_quadrupled_norm = e1_squared_norms_[edge_pair_index] * e1_squared_norms_[edge_pair_index];
+		const double e2_quadrupled_norm = e2_squared_norms_[edge_pair_index] * e2_squared_norms_[edge_pair_index];
+
+		const double p1 = (2 * e1_x * e1_y) / e1_quadrupled_norm;
+		const double q1 = (e1_x * e1_x - e1_y * e1_y) / e1_quadrupled_norm;
+		const double p2 = (2 * e2_x * e2_y) / e2_quadrupled_norm;
+		const double q2 = (e2_x * e2_x - e2_y * e2_y) / e2_quadrupled_norm;
+
+		Eigen::Matrix2d B1;
+		B1 << p1, -q1,
+			 -q1, -p1;
+
+		Eigen::Matrix2d B2;
+		B2 << -p2, q2,
+			   q2, p2;
+
+		angle_H.setZero();
+		angle_H.template block<2, 2>(0, 0) = B1;
+		angle_H.template block<2, 2>(0, 2) = -B1;
+		angle_H.template block<2, 2>(2, 0) = -B1;
+		angle_H.template block<2, 2>(2, 2) = B1;
+		angle_H.template block<2, 2>(4, 4) = B2;
+		angle_H.template block<2, 2>(4, 6) = -B2;
+		angle_H.template block<2, 2>(6, 4) = -B2;
+		angle_H.template block<2, 2>(6, 6) = B2;
+	}
+
+	// Hessian of the (unweighted) edge pair length term, (|e1|^2 - |e2|^2)^2, where e = v2 - v1
+	void CalculateLocalLengthHessian(const int64_t edge_pair_index, LocalHessian& length_H) const
+	{
+		Eigen::Vector2d e1(e1_x_[edge_pair_index], e1_y_[edge_pair_index]);
+		Eigen::Vector2d e2(e2_x_[edge_pair_index], e2_y_[edge_pair_index]);
+		const Eigen::Matrix2d I_scaled = 4 * squared_norm_diffs_[edge_pair_index] * Eigen::Matrix2d::Identity();
+		const Eigen::Matrix2d D11 = 8 * e1 * e1.transpose() + I_scaled;
+		const Eigen::Matrix2d D12 = -8 * e1 * e2.transpose();
+		const Eigen::Matrix2d D22 = 8 * e2 * e2.transpose() - I_scaled;
+
+		// Each vertex block is the edge block scaled by -1 (first vertex) or 1 (second vertex) of both edges
+		length_H.template block<2, 2>(0, 0) = D11;
+		length_H.template block<2, 2>(0, 2) = -D11;
+		length_H.template block<2, 2>(0, 4) = D12;
+		length_H.template block<2, 2>(0, 6) = -D12;
+		length_H.template block<2, 2>(2, 0) = -D11;
+		length_H.template block<2, 2>(2, 2) = D11;
+		length_H.template block<2, 2>(2, 4) = -D12;
+		length_H.template block<2, 2>(2, 6) = D12;
+		length_H.template block<2, 2>(4, 0) = D12.transpose();
+		length_H.template block<2, 2>(4, 2) = -D12.transpose();
+		length_H.template block<2, 2>(4, 4) = D22;
+		length_H.template block<2, 2>(4, 6) = -D22;
+		length_H.template block<2, 2>(6, 0) = -D12.transpose();
+		length_H.template block<2, 2>(6, 2) = D12.transpose();
+		length_H.template block<2, 2>(6, 4) = -D22;
+		length_H.template block<2, 2>(6, 6) = D22;
+	}
+
+	double CalculateTranslationHessianCoefficient(const double second_derivative) const
+	{
+		if (enforce_children_psd_ && second_derivative < 0)
+		{
+			return 10e-8 / 2;
+		}
+
+		return second_derivative;
+	}
+
+	// Projects the local hessian onto the cone of PSD matrices, by clamping its negative eigenvalues to 10e-8 (as ConcreteObjective does)
+	static void ProjectToPsd(LocalHessian& H)
+	{
+		Eigen::SelfAdjointEigenSolver<LocalHessian> eigen_solver(H);
+		const LocalGradient D = eigen_solver.eigenvalues().unaryExpr([](const double eigenvalue) { return eigenvalue < 0 ? 10e-8 : eigenvalue; });
+		const LocalHessian& V = eigen_solver.eigenvectors();
+		H = V * D.asDiagonal() * V.transpose();
+	}
+
+	/**
+	 * Private fields
+	 */
+	bool enforce_children_psd_;
+
+	double zeta_;
+	double interval_;
+
+	double angle_weight_;
+	double length_weight_;
+	double translation_weight_;
+
+	Eigen::Matrix<double, 6, 1> angle_polynomial_coeffs_;
+	Eigen::Matrix<double, 6, 1> translation_polynomial_coeffs_;
+
+	// Edge pair indices
+	std::vector<RDS::VertexIndex> e1_v1_indices_;
+	std::vector<RDS::VertexIndex> e1_v2_indices_;
+	std::vector<RDS::VertexIndex> e2_v1_indices_;
+	std::vector<RDS::VertexIndex> e2_v2_indices_;
+
+	std::vector<RDS::SparseVariableIndex> e1_v1_x_indices_;
+	std::vector<RDS::SparseVariableIndex> e1_v1_y_indices_;
+	std::vector<RDS::SparseVariableIndex> e1_v2_x_indices_;
+	std::vector<RDS::SparseVariableIndex> e1_v2_y_indices_;
+	std::vector<RDS::SparseVariableIndex> e2_v1_x_indices_;
+	std::vector<RDS::SparseVariableIndex> e2_v1_y_indices_;
+	std::vector<RDS::SparseVariableIndex> e2_v2_x_indices_;
+	std::vector<RDS::SparseVariableIndex> e2_v2_y_indices_;
+
+	std::vector<RDS::EdgeIndex> domain_edge_indices_;
+	std::vector<RDS::EdgeIndex> image_edge_1_indices_;
+	std::vector<RDS::EdgeIndex> image_edge_2_indices_;
+
+	// Domain edge index to edge pair index lookup table (-1 for domain edges that are not seam edges)
+	std::vector<int64_t> domain_edge_to_edge_pair_index_;
+
+	// Edge pair weights
+	std::vector<double> edge_angle_weights_;
+	std::vector<double> edge_length_weights_;
+
+	// Edge pair evaluations
+	std::vector<double> e1_x_;
+	std::vector<double> e1_y_;
+	std::vector<double> e2_x_;
+	std::vector<double> e2_y_;
+	std::vector<double> e1_squared_norms_;
+	std::vector<double> e2_squared_norms_;
+	std::vector<double> angle_values_;
+	std::vector<double> angle_first_derivatives_;
+	std::vector<double> angle_second_derivatives_;
+	std::vector<double> squared_norm_diffs_;
+	std::vector<double> translation_x_values_;
+	std::vector<double> translation_x_first_derivatives_;
+	std::vector<double> translation_x_second_derivatives_;
+	std::vector<double> translation_y_values_;
+	std::vector<double> translation_y_first_derivatives_;
+	std::vector<double> translation_y_second_derivatives_;
+
+	// Value per edge
+	Eigen::VectorXd image_angle_value_per_edge_;
+	Eigen::VectorXd image_length_value_per_edge_;
+	Eigen::VectorXd domain_angle_value_per_edge_;
+	Eigen::VectorXd domain_length_value_per_edge_;
+
+	// Published value per edge
+	Eigen::VectorXd published_image_angle_value_per_edge_;
+	Eigen::VectorXd published_image_length_value_per_edge_;
+	Eigen::VectorXd published_domain_angle_value_per_edge_;
+	Eigen::VectorXd published_domain_length_value_per_edge_;
+};
+
+#endif
@@ -4,6 +4,7 @@
 
 // STL includes
 #include <memory>
+#include <algorithm>
 
 // Optimization lib includes
 #include "../core/core.h"
@@ -56,6 +57,44 @@ protected:
 	 */
 	virtual void CalculateDerivativesOuter(const double x, double& outer_value, double& outer_first_derivative, double& outer_second_derivative) = 0;
 
+	/**
+	 * The hessian of the composition is H = f'(u) * H_inner + f''(u) * g_inner * g_inner^T.
+	 * - For a linear inner objective (H_inner = 0), H has rank 1 and its only nonzero eigenvalue is f''(u) * |g_inner|^2, so it is projected in closed form.
+	 * - For a PSD inner hessian and non-negative outer derivatives, H is a sum of PSD matrices and needs no projection.
+	 * Any other case falls back to the eigen-decomposition of the local hessian.
+	 */
+	void CalculateConvexTriplets(std::vector<Eigen::Triplet<double>>& triplets) override
+	{
+		if (!this->GetEnforcePsd())
+		{
+			return;
+		}
+
+		if (IsInnerHessianZero())
+		{
+			if (outer_second_derivative_ < 0)
+			{
+				// The single negative eigenvalue is clamped to 10e-8, as done by the eigen-decomposition projection
+				auto& g_inner = inner_objective_->GetGradient();
+				const double g_inner_squared_norm = g_inner.squaredNorm();
+				const double coefficient = g_inner_squared_norm > 0 ? 10e-8 / g_inner_squared_norm : 0;
+				for (auto& triplet : triplets)
+				{
+					const_cast<double&>(triplet.value()) = coefficient * g_inner.coeff(triplet.row()) * g_inner.coeff(triplet.col());
+				}
+			}
+
+			return;
+		}
+
+		if (inner_objective_->GetEnforcePsd() && outer_first_derivative_ >= 0 && outer_second_derivative_ >= 0)
+		{
+			return;
+		}
+
+		SparseObjectiveFunction<StorageOrder_>::CalculateConvexTriplets(triplets);
+	}
+
 private:
 	/**
 	 * Private method overrides
@@ -72,7 +111,16 @@ private:
 
 	void CalculateGradient(Eigen::SparseVector<double>& g) override
 	{
-		g = outer_first_derivative_ * inner_objective_->GetGradient();
+		// Once g shares the sparsity structure of the inner gradient, its values are scaled in place (assigning a sparse expression reallocates g)
+		const auto& g_inner = inner_objective_->GetGradient();
+		const auto nonzeros_count = g_inner.nonZeros();
+		if (g.nonZeros() != nonzeros_count || !std::equal(g_inner.innerIndexPtr(), g_inner.innerIndexPtr() + nonzeros_count, g.innerIndexPtr()))
+		{
+			g = outer_first_derivative_ * g_inner;
+			return;
+		}
+
+		Eigen::Map<Eigen::VectorXd>(g.valuePtr(), nonzeros_count) = outer_first_derivative_ * Eigen::Map<const Eigen::VectorXd>(g_inner.valuePtr(), nonzeros_count);
 	}
 
 	void CalculateRawTriplets(std::vector<Eigen::Triplet<double>>& triplets) override
@@ -86,6 +134,19 @@ private:
 		}
 	}
 
+	bool IsInnerHessianZero() const
+	{
+		for (const auto& triplet : inner_objective_->GetTriplets())
+		{
+			if (triplet.value() != 0)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
 	/**
 	 * Private fields
 	 */
@@ -9,6 +9,8 @@
 #include <mutex>
 #include <any>
 #include <limits>
+#include <vector>
+#include <algorithm>
 
 // Eigen Includes
 #include <Eigen/Core>
@@ -71,19 +73,28 @@ public:
 		return sparse_variable_indices_;
 	}
 
-	const RDS::HessianEntryToTripletIndexMap& GetHessianEntryToTripletIndexMap() const
+	// The sparse variable indices are sorted, so the dense index of a variable is its position in GetSparseVariablesIndices()
+	RDS::SparseVariableIndex GetSparseVariableIndex(const RDS::DenseVariableIndex dense_variable_index) const
 	{
-		return hessian_entry_to_triplet_index_map_;
+		return sparse_variable_indices_[dense_variable_index];
 	}
 
-	const RDS::SparseVariableIndexToDenseVariableIndexMap& GetSparseVariableIndexToDenseVariableIndexMap() const
+	RDS::DenseVariableIndex GetDenseVariableIndex(const RDS::SparseVariableIndex sparse_variable_index) const
 	{
-		return sparse_variable_index_to_dense_variable_index_map_;
+		// An objective has only a handful of variables, so a binary search over the sorted indices beats hashing
+		const auto it = std::lower_bound(sparse_variable_indices_.begin(), sparse_variable_indices_.end(), sparse_variable_index);
+		if (it == sparse_variable_indices_.end() || *it != sparse_variable_index)
+		{
+			throw std::exception("Variable is not an objective variable");
+		}
+
+		return static_cast<RDS::DenseVariableIndex>(it - sparse_variable_indices_.begin());
 	}
 
-	const RDS::DenseVariableIndexToSparseVariableIndexMap& GetDenseVariableIndexToSparseVariableIndexMap() const
+	// Triplets are laid out as the column-major upper triangle of the local hessian (see CreateTriplets())
+	static RDS::HessianTripletIndex GetHessianTripletIndex(const RDS::DenseVariableIndex row, const RDS::DenseVariableIndex column)
 	{
-		return dense_variable_index_to_sparse_variable_index_map_;
+		return ((column * (column + 1)) / 2) + row;
 	}
 
 	/**
@@ -108,6 +119,38 @@ protected:
 
 	// Parallelism enabled flag
 	bool parallelism_enabled_;
+
+	/**
+	 * Protected methods
+	 */
+
+	// Projects the local hessian (given by its triplets) onto the cone of PSD matrices, by clamping its negative eigenvalues
+	virtual void CalculateConvexTriplets(std::vector<Eigen::Triplet<double>>& triplets)
+	{
+		if (enforce_psd_)
+		{
+			// Dispatch to fixed-size (allocation-free) kernels for the common local hessian sizes
+			switch (objective_variables_count_)
+			{
+			case 2:
+				ProjectTripletsToPsd<2>(triplets);
+				break;
+			case 4:
+				ProjectTripletsToPsd<4>(triplets);
+				break;
+			case 6:
+				ProjectTripletsToPsd<6>(triplets);
+				break;
+			case 8:
+				ProjectTripletsToPsd<8>(triplets);
+				break;
+			default:
+				dynamic_H_.resize(objective_variables_count_, objective_variables_count_);
+				ProjectTripletsToPsd(triplets, dynamic_H_, dynamic_eigen_solver_);
+				break;
+			}
+		}
+	}
 	
 private:
 
@@ -119,17 +162,14 @@ private:
 		// Empty implementation
 	}
 
-	virtual void InitializeMappings(
-		RDS::SparseVariableIndexToDenseVariableIndexMap& sparse_variable_index_to_dense_variable_index_map,
-		RDS::DenseVariableIndexToSparseVariableIndexMap& dense_variable_index_to_sparse_variable_index_map,
-		RDS::SparseVariableIndexToVertexIndexMap& sparse_variable_index_to_vertex_index_map)
+	void InitializeMappings()
 	{
 		std::sort(sparse_variable_indices_.begin(), sparse_variable_indices_.end());
-		for (std::size_t i = 0; i < sparse_variable_indices_.size(); i++)
+		const auto sparse_variables_indices_count = sparse_variable_indices_.size();
+		dense_variable_index_to_vertex_index_.resize(sparse_variables_indices_count);
+		for (std::size_t i = 0; i < sparse_variables_indices_count; i++)
 		{
-			dense_variable_index_to_sparse_variable_index_map.insert({ i, sparse_variable_indices_[i] });
-			sparse_variable_index_to_dense_variable_index_map.insert({ sparse_variable_indices_[i], i });
-			sparse_variable_index_to_vertex_index_map.insert({ sparse_variable_indices_[i], mesh_data_provider_->GetVertexIndex(sparse_variable_indices_[i])});
+			dense_variable_index_to_vertex_index_[i] = mesh_data_provider_->GetVertexIndex(sparse_variable_indices_[i]);
 		}
 	}
 
@@ -143,11 +183,10 @@ private:
 			for (auto row = 0; row <= column; row++)
 			{
 				triplets[triplet_index] = Eigen::Triplet<double>(
-					dense_variable_index_to_sparse_variable_index_map_[row],
-					dense_variable_index_to_sparse_variable_index_map_[column],
+					sparse_variable_indices_[row],
+					sparse_variable_indices_[column],
 					0);
 
-				hessian_entry_to_triplet_index_map_[{ row, column }] = triplet_index;
 				triplet_index++;
 			}
 		}
@@ -155,23 +194,26 @@ private:
 
 	virtual void InitializeTriplets(std::vector<Eigen::Triplet<double>>& triplets)
 	{
+		sparse_variable_indices_.clear();
 		InitializeSparseVariableIndices(sparse_variable_indices_);
-		InitializeMappings(
-			sparse_variable_index_to_dense_variable_index_map_,
-			dense_variable_index_to_sparse_variable_index_map_,
-			sparse_variable_index_to_vertex_index_map_);
+		InitializeMappings();
 		CreateTriplets(triplets);
 	}
 
 	// Value, gradient and hessian calculation functions
 	virtual void CalculateValuePerVertex(VectorType_& f_per_vertex)
 	{
+		// Only the entries of the objective's own vertices are touched, so the cost does not depend on the mesh size
 		const double value = this->GetValue();
-		f_per_vertex.setZero();
-		const auto sparse_variables_indices_count = sparse_variable_indices_.size();
+		const auto sparse_variables_indices_count = dense_variable_index_to_vertex_index_.size();
 		for (std::size_t i = 0; i < sparse_variables_indices_count; i++)
 		{
-			f_per_vertex.coeffRef(sparse_variable_index_to_vertex_index_map_[sparse_variable_indices_[i]]) += value;
+			f_per_vertex.coeffRef(dense_variable_index_to_vertex_index_[i]) = 0;
+		}
+
+		for (std::size_t i = 0; i < sparse_variables_indices_count; i++)
+		{
+			f_per_vertex.coeffRef(dense_variable_index_to_vertex_index_[i]) += value;
 		}
 	}
 
@@ -188,45 +230,49 @@ private:
 
 	virtual void CalculateRawTriplets(std::vector<Eigen::Triplet<double>>& triplets) = 0;
 	
-	void CalculateConvexTriplets(std::vector<Eigen::Triplet<double>>& triplets)
+	template<int Size_>
+	void ProjectTripletsToPsd(std::vector<Eigen::Triplet<double>>& triplets)
 	{
-		if (enforce_psd_)
-		{
-			Eigen::MatrixXd H;
-			H.resize(objective_variables_count_, objective_variables_count_);
-			H.setZero();
-
-			auto triplets_count = triplets.size();
-			for (std::size_t i = 0; i < triplets_count; i++)
-			{
-				auto row = sparse_variable_index_to_dense_variable_index_map_[triplets[i].row()];
-				auto col = sparse_variable_index_to_dense_variable_index_map_[triplets[i].col()];
-				auto value = triplets[i].value();
-				H.coeffRef(row, col) = value;
-				H.coeffRef(col, row) = value;
-			}
+		Eigen::Matrix<double, Size_, Size_> H;
+		Eigen::SelfAdjointEigenSolver<Eigen::Matrix<double, Size_, Size_>> eigen_solver;
+		ProjectTripletsToPsd(triplets, H, eigen_solver);
+	}
 
-			Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(H);
-			Eigen::MatrixXd D = solver.eigenvalues().asDiagonal();
-			Eigen::MatrixXd V = solver.eigenvectors();
-			for (auto i = 0; i < objective_variables_count_; i++)
+	template<typename MatrixType_, typename EigenSolverType_>
+	void ProjectTripletsToPsd(std::vector<Eigen::Triplet<double>>& triplets, MatrixType_& H, EigenSolverType_& eigen_solver)
+	{
+		// Triplets are laid out as the column-major upper triangle of the local hessian (see CreateTriplets())
+		int64_t triplet_index = 0;
+		for (int64_t column = 0; column < objective_variables_count_; column++)
+		{
+			for (int64_t row = 0; row <= column; row++)
 			{
-				auto& value = D.coeffRef(i, i);
-				if (value < 0)
-				{
-					value = 10e-8;
-				}
+				const double value = triplets[triplet_index].value();
+				H.coeffRef(row, column) = value;
+				H.coeffRef(column, row) = value;
+				triplet_index++;
 			}
+		}
 
-			H = V * D * V.transpose();
+		eigen_solver.compute(H);
+		const auto& D = eigen_solver.eigenvalues();
+		const auto& V = eigen_solver.eigenvectors();
 
-			for (auto column = 0; column < objective_variables_count_; column++)
+		// H = V * max(D, 10e-8) * V^T, evaluated entry-wise over the upper triangle to avoid temporaries
+		triplet_index = 0;
+		for (int64_t column = 0; column < objective_variables_count_; column++)
+		{
+			for (int64_t row = 0; row <= column; row++)
 			{
-				for (auto row = 0; row <= column; row++)
+				double value = 0;
+				for (int64_t i = 0; i < objective_variables_count_; i++)
 				{
-					const auto triplet_index = hessian_entry_to_triplet_index_map_[{row, column}];
-					const_cast<double&>(triplets[triplet_index].value()) = H.coeffRef(row, column);
+					const double eigenvalue = D.coeff(i) < 0 ? 10e-8 : D.coeff(i);
+					value += V.coeff(row, i) * eigenvalue * V.coeff(column, i);
 				}
+
+				const_cast<double&>(triplets[triplet_index].value()) = value;
+				triplet_index++;
 			}
 		}
 	}
@@ -238,14 +284,15 @@ private:
 	// Enforce PSD
 	bool enforce_psd_;
 
-	// Sparse variable indices
+	// PSD projection buffers for local hessians without a fixed-size kernel
+	Eigen::MatrixXd dynamic_H_;
+	Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> dynamic_eigen_solver_;
+
+	// Sparse variable indices (sorted, indexed by dense variable index)
 	std::vector<RDS::SparseVariableIndex> sparse_variable_indices_;
 
-	// Mappings
-	RDS::HessianEntryToTripletIndexMap hessian_entry_to_triplet_index_map_;
-	RDS::SparseVariableIndexToDenseVariableIndexMap sparse_variable_index_to_dense_variable_index_map_;
-	RDS::DenseVariableIndexToSparseVariableIndexMap dense_variable_index_to_sparse_variable_index_map_;
-	RDS::SparseVariableIndexToVertexIndexMap sparse_variable_index_to_vertex_index_map_;
+	// Mappings (indexed by dense variable index)
+	std::vector<RDS::VertexIndex> dense_variable_index_to_vertex_index_;
 };
 
 #endif
\ No newline at end of file
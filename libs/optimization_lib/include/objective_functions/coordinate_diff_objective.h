@@ -34,8 +34,19 @@ protected:
 
 	void CalculateGradient(Eigen::SparseVector<double>& g) override
 	{
-		g.coeffRef(coordinate_diff_data_provider_->GetSparseVariable1Index()) = 1;
-		g.coeffRef(coordinate_diff_data_provider_->GetSparseVariable2Index()) = -1;
+		// Empty implementation (the gradient is expanded from the local gradient, see CalculateLocalGradient())
+	}
+
+	void InitializeLocalGradient(std::vector<RDS::SparseVariableIndex>& local_gradient_indices) override
+	{
+		local_gradient_indices.push_back(coordinate_diff_data_provider_->GetSparseVariable1Index());
+		local_gradient_indices.push_back(coordinate_diff_data_provider_->GetSparseVariable2Index());
+	}
+
+	void CalculateLocalGradient(Eigen::VectorXd& local_g) override
+	{
+		local_g.coeffRef(0) = 1;
+		local_g.coeffRef(1) = -1;
 	}
 
 	void CalculateRawTriplets(std::vector<Eigen::Triplet<double>>& triplets) override
@@ -34,7 +34,17 @@ protected:
 
 	void CalculateGradient(Eigen::SparseVector<double>& g) override
 	{
-		g.coeffRef(coordinate_data_provider_->GetSparseVariableIndex()) = 1;
+		// Empty implementation (the gradient is expanded from the local gradient, see CalculateLocalGradient())
+	}
+
+	void InitializeLocalGradient(std::vector<RDS::SparseVariableIndex>& local_gradient_indices) override
+	{
+		local_gradient_indices.push_back(coordinate_data_provider_->GetSparseVariableIndex());
+	}
+
+	void CalculateLocalGradient(Eigen::VectorXd& local_g) override
+	{
+		local_g.coeffRef(0) = 1;
 	}
 
 	void CalculateRawTriplets(std::vector<Eigen::Triplet<double>>& triplets) override
@@ -29,6 +29,12 @@ public:
 	}
 
 protected:
+	/**
+	 * Protected type definitions
+	 */
+	using EdgePairObjective<StorageOrder_>::LocalVariablesCount;
+	using typename EdgePairObjective<StorageOrder_>::LocalGradient;
+
 	/**
 	 * Protected overrides
 	 */	
@@ -60,73 +66,34 @@ protected:
 		/**
 		 * First partial derivatives
 		 */
-		this->dense_index_to_first_derivative_value_map_[this->e1_v1_x_dense_index_] = e1_y_to_e1_squared_norm;
-		this->dense_index_to_first_derivative_value_map_[this->e1_v1_y_dense_index_] = e1_x_to_e1_squared_norm;
-		this->dense_index_to_first_derivative_value_map_[this->e1_v2_x_dense_index_] = e1_y_to_e1_squared_norm;
-		this->dense_index_to_first_derivative_value_map_[this->e1_v2_y_dense_index_] = e1_x_to_e1_squared_norm;
-		this->dense_index_to_first_derivative_value_map_[this->e2_v1_x_dense_index_] = e2_y_to_e2_squared_norm;
-		this->dense_index_to_first_derivative_value_map_[this->e2_v1_y_dense_index_] = e2_x_to_e2_squared_norm;
-		this->dense_index_to_first_derivative_value_map_[this->e2_v2_x_dense_index_] = e2_y_to_e2_squared_norm;
-		this->dense_index_to_first_derivative_value_map_[this->e2_v2_y_dense_index_] = e2_x_to_e2_squared_norm;
+		this->first_derivative_values_ <<
+			e1_y_to_e1_squared_norm, e1_x_to_e1_squared_norm, e1_y_to_e1_squared_norm, e1_x_to_e1_squared_norm,
+			e2_y_to_e2_squared_norm, e2_x_to_e2_squared_norm, e2_y_to_e2_squared_norm, e2_x_to_e2_squared_norm;
 
 		/**
-		 * Second partial derivatives
+		 * Second partial derivatives (each edge depends only on its own vertices)
 		 */
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_x_dense_index_][this->e1_v1_x_dense_index_] = e1_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_x_dense_index_][this->e1_v1_y_dense_index_] = -e1_squares_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_x_dense_index_][this->e1_v2_x_dense_index_] = -e1_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_x_dense_index_][this->e1_v2_y_dense_index_] = e1_squares_diff_prod_to_quad_norm;
-
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_x_dense_index_][this->e1_v1_x_dense_index_] = e1_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_x_dense_index_][this->e1_v1_y_dense_index_] = -e1_squares_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_x_dense_index_][this->e1_v2_x_dense_index_] = -e1_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_x_dense_index_][this->e1_v2_y_dense_index_] = e1_squares_diff_prod_to_quad_norm;
-
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_y_dense_index_][this->e1_v1_x_dense_index_] = e1_squares_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_y_dense_index_][this->e1_v1_y_dense_index_] = e1_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_y_dense_index_][this->e1_v2_x_dense_index_] = -e1_squares_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_y_dense_index_][this->e1_v2_y_dense_index_] = -e1_diff_prod_to_quad_norm;
-
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_y_dense_index_][this->e1_v1_x_dense_index_] = e1_squares_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_y_dense_index_][this->e1_v1_y_dense_index_] = e1_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_y_dense_index_][this->e1_v2_x_dense_index_] = -e1_squares_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_y_dense_index_][this->e1_v2_y_dense_index_] = -e1_diff_prod_to_quad_norm;
-
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_x_dense_index_][this->e2_v1_x_dense_index_] = e2_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_x_dense_index_][this->e2_v1_y_dense_index_] = -e2_squares_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_x_dense_index_][this->e2_v2_x_dense_index_] = -e2_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_x_dense_index_][this->e2_v2_y_dense_index_] = e2_squares_diff_prod_to_quad_norm;
-
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_x_dense_index_][this->e2_v1_x_dense_index_] = e2_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_x_dense_index_][this->e2_v1_y_dense_index_] = -e2_squares_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_x_dense_index_][this->e2_v2_x_dense_index_] = -e2_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_x_dense_index_][this->e2_v2_y_dense_index_] = e2_squares_diff_prod_to_quad_norm;
-
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_y_dense_index_][this->e2_v1_x_dense_index_] = e2_squares_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_y_dense_index_][this->e2_v1_y_dense_index_] = e2_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_y_dense_index_][this->e2_v2_x_dense_index_] = -e2_squares_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_y_dense_index_][this->e2_v2_y_dense_index_] = -e2_diff_prod_to_quad_norm;
-
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_y_dense_index_][this->e2_v1_x_dense_index_] = e2_squares_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_y_dense_index_][this->e2_v1_y_dense_index_] = e2_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_y_dense_index_][this->e2_v2_x_dense_index_] = -e2_squares_diff_prod_to_quad_norm;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_y_dense_index_][this->e2_v2_y_dense_index_] = -e2_diff_prod_to_quad_norm;
+		Eigen::Matrix2d d_edge1;
+		d_edge1 <<
+			e1_diff_prod_to_quad_norm, -e1_squares_diff_prod_to_quad_norm,
+			e1_squares_diff_prod_to_quad_norm, e1_diff_prod_to_quad_norm;
+
+		Eigen::Matrix2d d_edge2;
+		d_edge2 <<
+			e2_diff_prod_to_quad_norm, -e2_squares_diff_prod_to_quad_norm,
+			e2_squares_diff_prod_to_quad_norm, e2_diff_prod_to_quad_norm;
+
+		this->second_derivative_values_.template block<4, 4>(0, 0) << d_edge1, -d_edge1, d_edge1, -d_edge1;
+		this->second_derivative_values_.template block<4, 4>(4, 4) << d_edge2, -d_edge2, d_edge2, -d_edge2;
 	}
 
 private:
 	/**
 	 * Private overrides
 	 */
-	void InitializeDenseIndexToFirstDerivativeSignMap(std::vector<double>& dense_index_to_first_derivative_sign_map) override
+	void InitializeFirstDerivativeSigns(LocalGradient& first_derivative_signs) override
 	{
-		dense_index_to_first_derivative_sign_map[this->e1_v1_x_dense_index_] =  1;
-		dense_index_to_first_derivative_sign_map[this->e1_v1_y_dense_index_] = -1;
-		dense_index_to_first_derivative_sign_map[this->e1_v2_x_dense_index_] = -1;
-		dense_index_to_first_derivative_sign_map[this->e1_v2_y_dense_index_] =  1;
-		dense_index_to_first_derivative_sign_map[this->e2_v1_x_dense_index_] = -1;
-		dense_index_to_first_derivative_sign_map[this->e2_v1_y_dense_index_] =  1;
-		dense_index_to_first_derivative_sign_map[this->e2_v2_x_dense_index_] =  1;
-		dense_index_to_first_derivative_sign_map[this->e2_v2_y_dense_index_] = -1;
+		first_derivative_signs << 1, -1, -1, 1, -1, 1, 1, -1;
 	}
 	
 	void CalculateValue(double& f) override
@@ -6,12 +6,14 @@
 #include <Eigen/Core>
 
 // Optimization lib includes
+#include "../../core/object_arena.h"
 #include "../summation_objective.h"
 #include "../coordinate_diff_objective.h"
 #include "../cross_coordinate_diff_objective.h"
 #include "../periodic_objective.h"
 #include "../../data_providers/edge_pair_data_provider.h"
 #include "../../data_providers/empty_data_provider.h"
+#include "../../data_providers/data_provider_registry.h"
 
 template <Eigen::StorageOptions StorageOrder_>
 class EdgePairIntegerTranslationObjective : public SummationObjective<PeriodicObjective<StorageOrder_>, Eigen::SparseVector<double>>
@@ -56,20 +58,21 @@ public:
 	void PreInitialize() override
 	{
 		auto edge_pair_data_provider = std::dynamic_pointer_cast<EdgePairDataProvider>(this->data_provider_);
-		auto empty_data_provider = std::make_shared<EmptyDataProvider>(this->GetMeshDataProvider());
+		auto empty_data_provider = DataProviderRegistry::GetEmptyDataProvider(this->GetMeshDataProvider());
+		ObjectArena& object_arena = this->GetMeshDataProvider()->GetObjectArena();
 
-		auto v1_x_coordinate_diff_data_provider = std::make_shared<CoordinateDiffDataProvider>(this->mesh_data_provider_, edge_pair_data_provider->GetEdge1Vertex1Index(), edge_pair_data_provider->GetEdge2Vertex1Index(), RDS::CoordinateType::X);
-		auto v1_y_coordinate_diff_data_provider = std::make_shared<CoordinateDiffDataProvider>(this->mesh_data_provider_, edge_pair_data_provider->GetEdge1Vertex1Index(), edge_pair_data_provider->GetEdge2Vertex1Index(), RDS::CoordinateType::Y);
+		auto v1_x_coordinate_diff_data_provider = DataProviderRegistry::GetCoordinateDiffDataProvider(this->mesh_data_provider_, edge_pair_data_provider->GetEdge1Vertex1Index(), edge_pair_data_provider->GetEdge2Vertex1Index(), RDS::CoordinateType::X);
+		auto v1_y_coordinate_diff_data_provider = DataProviderRegistry::GetCoordinateDiffDataProvider(this->mesh_data_provider_, edge_pair_data_provider->GetEdge1Vertex1Index(), edge_pair_data_provider->GetEdge2Vertex1Index(), RDS::CoordinateType::Y);
 		//auto v2_x_coordinate_diff_data_provider = std::make_shared<CoordinateDiffDataProvider>(this->mesh_data_provider_, edge_pair_data_provider->GetEdge1Vertex2Index(), edge_pair_data_provider->GetEdge2Vertex2Index(), RDS::CoordinateType::X);
 		//auto v2_y_coordinate_diff_data_provider = std::make_shared<CoordinateDiffDataProvider>(this->mesh_data_provider_, edge_pair_data_provider->GetEdge1Vertex2Index(), edge_pair_data_provider->GetEdge2Vertex2Index(), RDS::CoordinateType::Y);
 
-		auto v1_x_coordinate_diff_objective = std::make_shared<CoordinateDiffObjective<StorageOrder_>>(this->GetMeshDataProvider(), v1_x_coordinate_diff_data_provider);
-		auto v1_y_coordinate_diff_objective = std::make_shared<CoordinateDiffObjective<StorageOrder_>>(this->GetMeshDataProvider(), v1_y_coordinate_diff_data_provider);
+		auto v1_x_coordinate_diff_objective = object_arena.MakeShared<CoordinateDiffObjective<StorageOrder_>>(this->GetMeshDataProvider(), v1_x_coordinate_diff_data_provider);
+		auto v1_y_coordinate_diff_objective = object_arena.MakeShared<CoordinateDiffObjective<StorageOrder_>>(this->GetMeshDataProvider(), v1_y_coordinate_diff_data_provider);
 		//auto v2_x_coordinate_diff_objective = std::make_shared<CoordinateDiffObjective<StorageOrder_>>(this->GetMeshDataProvider(), v2_x_coordinate_diff_data_provider);
 		//auto v2_y_coordinate_diff_objective = std::make_shared<CoordinateDiffObjective<StorageOrder_>>(this->GetMeshDataProvider(), v2_y_coordinate_diff_data_provider);
 
-		auto periodic_v1_x_coordinate_diff_objective = std::make_shared<PeriodicObjective<StorageOrder_>>(this->GetMeshDataProvider(), empty_data_provider, v1_x_coordinate_diff_objective, 1.0f, this->GetEnforceChildrenPsd());
-		auto periodic_v1_y_coordinate_diff_objective = std::make_shared<PeriodicObjective<StorageOrder_>>(this->GetMeshDataProvider(), empty_data_provider, v1_y_coordinate_diff_objective, 1.0f, this->GetEnforceChildrenPsd());
+		auto periodic_v1_x_coordinate_diff_objective = object_arena.MakeShared<PeriodicObjective<StorageOrder_>>(this->GetMeshDataProvider(), empty_data_provider, v1_x_coordinate_diff_objective, 1.0f, this->GetEnforceChildrenPsd());
+		auto periodic_v1_y_coordinate_diff_objective = object_arena.MakeShared<PeriodicObjective<StorageOrder_>>(this->GetMeshDataProvider(), empty_data_provider, v1_y_coordinate_diff_objective, 1.0f, this->GetEnforceChildrenPsd());
 		//auto periodic_v2_x_coordinate_diff_objective = std::make_shared<PeriodicObjective<StorageOrder_>>(this->GetMeshDataProvider(), empty_data_provider, v2_x_coordinate_diff_objective, 1.0f, this->GetEnforceChildrenPsd());
 		//auto periodic_v2_y_coordinate_diff_objective = std::make_shared<PeriodicObjective<StorageOrder_>>(this->GetMeshDataProvider(), empty_data_provider, v2_y_coordinate_diff_objective, 1.0f, this->GetEnforceChildrenPsd());
 
@@ -25,6 +25,12 @@ public:
 	}
 
 protected:
+	/**
+	 * Protected type definitions
+	 */
+	using EdgePairObjective<StorageOrder_>::LocalVariablesCount;
+	using typename EdgePairObjective<StorageOrder_>::LocalGradient;
+
 	/**
 	 * Protected overrides
 	 */
@@ -49,131 +55,35 @@ protected:
 		Eigen::Matrix2d I_scaled = squared_norm_diff_scaled * I;
 
 		Eigen::Matrix2d d_edge1_d_edge1 = 8 * edge1 * edge1.transpose() + I_scaled;
-		Eigen::Matrix2d d_edge1_v1_d_edge1_v1 = -d_edge1_d_edge1;
-		Eigen::Matrix2d d_edge1_v1_d_edge1_v2 = d_edge1_d_edge1;
-		Eigen::Matrix2d d_edge1_v2_d_edge1_v1 = -d_edge1_d_edge1;
-		Eigen::Matrix2d d_edge1_v2_d_edge1_v2 = d_edge1_d_edge1;
-
 		Eigen::Matrix2d d_edge1_d_edge2 = 8 * edge1 * edge2.transpose();
-		Eigen::Matrix2d d_edge1_v1_d_edge2_v1 = d_edge1_d_edge2;
-		Eigen::Matrix2d d_edge1_v1_d_edge2_v2 = -d_edge1_d_edge2;
-		Eigen::Matrix2d d_edge1_v2_d_edge2_v1 = d_edge1_d_edge2;
-		Eigen::Matrix2d d_edge1_v2_d_edge2_v2 = -d_edge1_d_edge2;
-
 		Eigen::Matrix2d d_edge2_d_edge1 = 8 * edge2 * edge1.transpose();
-		Eigen::Matrix2d d_edge2_v1_d_edge1_v1 = -d_edge2_d_edge1;
-		Eigen::Matrix2d d_edge2_v1_d_edge1_v2 = d_edge2_d_edge1;
-		Eigen::Matrix2d d_edge2_v2_d_edge1_v1 = -d_edge2_d_edge1;
-		Eigen::Matrix2d d_edge2_v2_d_edge1_v2 = d_edge2_d_edge1;
-
 		Eigen::Matrix2d d_edge2_d_edge2 = -8 * edge2 * edge2.transpose() + I_scaled;
-		Eigen::Matrix2d d_edge2_v1_d_edge2_v1 = -d_edge2_d_edge2;
-		Eigen::Matrix2d d_edge2_v1_d_edge2_v2 = d_edge2_d_edge2;
-		Eigen::Matrix2d d_edge2_v2_d_edge2_v1 = -d_edge2_d_edge2;
-		Eigen::Matrix2d d_edge2_v2_d_edge2_v2 = d_edge2_d_edge2;
+
+		// Derivatives of the scaled edges w.r.t. (edge1 v1, edge1 v2, edge2 v1, edge2 v2)
+		Eigen::Matrix<double, 2, LocalVariablesCount> d_edge1_scaled;
+		d_edge1_scaled << -d_edge1_d_edge1, d_edge1_d_edge1, d_edge1_d_edge2, -d_edge1_d_edge2;
+
+		Eigen::Matrix<double, 2, LocalVariablesCount> d_edge2_scaled;
+		d_edge2_scaled << -d_edge2_d_edge1, d_edge2_d_edge1, -d_edge2_d_edge2, d_edge2_d_edge2;
 
 		/**
 		 * First partial derivatives
 		 */
-		this->dense_index_to_first_derivative_value_map_[this->e1_v1_x_dense_index_] = edge1_scaled.coeff(0);
-		this->dense_index_to_first_derivative_value_map_[this->e1_v1_y_dense_index_] = edge1_scaled.coeff(1);
-		this->dense_index_to_first_derivative_value_map_[this->e1_v2_x_dense_index_] = edge1_scaled.coeff(0);
-		this->dense_index_to_first_derivative_value_map_[this->e1_v2_y_dense_index_] = edge1_scaled.coeff(1);
-		this->dense_index_to_first_derivative_value_map_[this->e2_v1_x_dense_index_] = edge2_scaled.coeff(0);
-		this->dense_index_to_first_derivative_value_map_[this->e2_v1_y_dense_index_] = edge2_scaled.coeff(1);
-		this->dense_index_to_first_derivative_value_map_[this->e2_v2_x_dense_index_] = edge2_scaled.coeff(0);
-		this->dense_index_to_first_derivative_value_map_[this->e2_v2_y_dense_index_] = edge2_scaled.coeff(1);
+		this->first_derivative_values_ << edge1_scaled, edge1_scaled, edge2_scaled, edge2_scaled;
 
 		/**
 		 * Second partial derivatives
 		 */
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_x_dense_index_][this->e1_v1_x_dense_index_] = d_edge1_v1_d_edge1_v1(0, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_x_dense_index_][this->e1_v1_y_dense_index_] = d_edge1_v1_d_edge1_v1(0, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_x_dense_index_][this->e1_v2_x_dense_index_] = d_edge1_v1_d_edge1_v2(0, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_x_dense_index_][this->e1_v2_y_dense_index_] = d_edge1_v1_d_edge1_v2(0, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_x_dense_index_][this->e2_v1_x_dense_index_] = d_edge1_v1_d_edge2_v1(0, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_x_dense_index_][this->e2_v1_y_dense_index_] = d_edge1_v1_d_edge2_v1(0, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_x_dense_index_][this->e2_v2_x_dense_index_] = d_edge1_v1_d_edge2_v2(0, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_x_dense_index_][this->e2_v2_y_dense_index_] = d_edge1_v1_d_edge2_v2(0, 1);
-
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_x_dense_index_][this->e1_v1_x_dense_index_] = d_edge1_v2_d_edge1_v1(0, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_x_dense_index_][this->e1_v1_y_dense_index_] = d_edge1_v2_d_edge1_v1(0, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_x_dense_index_][this->e1_v2_x_dense_index_] = d_edge1_v2_d_edge1_v2(0, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_x_dense_index_][this->e1_v2_y_dense_index_] = d_edge1_v2_d_edge1_v2(0, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_x_dense_index_][this->e2_v1_x_dense_index_] = d_edge1_v2_d_edge2_v1(0, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_x_dense_index_][this->e2_v1_y_dense_index_] = d_edge1_v2_d_edge2_v1(0, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_x_dense_index_][this->e2_v2_x_dense_index_] = d_edge1_v2_d_edge2_v2(0, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_x_dense_index_][this->e2_v2_y_dense_index_] = d_edge1_v2_d_edge2_v2(0, 1);
-
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_y_dense_index_][this->e1_v1_x_dense_index_] = d_edge1_v1_d_edge1_v1(1, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_y_dense_index_][this->e1_v1_y_dense_index_] = d_edge1_v1_d_edge1_v1(1, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_y_dense_index_][this->e1_v2_x_dense_index_] = d_edge1_v1_d_edge1_v2(1, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_y_dense_index_][this->e1_v2_y_dense_index_] = d_edge1_v1_d_edge1_v2(1, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_y_dense_index_][this->e2_v1_x_dense_index_] = d_edge1_v1_d_edge2_v1(1, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_y_dense_index_][this->e2_v1_y_dense_index_] = d_edge1_v1_d_edge2_v1(1, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_y_dense_index_][this->e2_v2_x_dense_index_] = d_edge1_v1_d_edge2_v2(1, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_y_dense_index_][this->e2_v2_y_dense_index_] = d_edge1_v1_d_edge2_v2(1, 1);
-
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_y_dense_index_][this->e1_v1_x_dense_index_] = d_edge1_v2_d_edge1_v1(1, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_y_dense_index_][this->e1_v1_y_dense_index_] = d_edge1_v2_d_edge1_v1(1, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_y_dense_index_][this->e1_v2_x_dense_index_] = d_edge1_v2_d_edge1_v2(1, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_y_dense_index_][this->e1_v2_y_dense_index_] = d_edge1_v2_d_edge1_v2(1, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_y_dense_index_][this->e2_v1_x_dense_index_] = d_edge1_v2_d_edge2_v1(1, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_y_dense_index_][this->e2_v1_y_dense_index_] = d_edge1_v2_d_edge2_v1(1, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_y_dense_index_][this->e2_v2_x_dense_index_] = d_edge1_v2_d_edge2_v2(1, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_y_dense_index_][this->e2_v2_y_dense_index_] = d_edge1_v2_d_edge2_v2(1, 1);
-
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_x_dense_index_][this->e1_v1_x_dense_index_] = d_edge2_v1_d_edge1_v1(0, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_x_dense_index_][this->e1_v1_y_dense_index_] = d_edge2_v1_d_edge1_v1(0, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_x_dense_index_][this->e1_v2_x_dense_index_] = d_edge2_v1_d_edge1_v2(0, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_x_dense_index_][this->e1_v2_y_dense_index_] = d_edge2_v1_d_edge1_v2(0, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_x_dense_index_][this->e2_v1_x_dense_index_] = d_edge2_v1_d_edge2_v1(0, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_x_dense_index_][this->e2_v1_y_dense_index_] = d_edge2_v1_d_edge2_v1(0, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_x_dense_index_][this->e2_v2_x_dense_index_] = d_edge2_v1_d_edge2_v2(0, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_x_dense_index_][this->e2_v2_y_dense_index_] = d_edge2_v1_d_edge2_v2(0, 1);
-
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_x_dense_index_][this->e1_v1_x_dense_index_] = d_edge2_v2_d_edge1_v1(0, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_x_dense_index_][this->e1_v1_y_dense_index_] = d_edge2_v2_d_edge1_v1(0, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_x_dense_index_][this->e1_v2_x_dense_index_] = d_edge2_v2_d_edge1_v2(0, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_x_dense_index_][this->e1_v2_y_dense_index_] = d_edge2_v2_d_edge1_v2(0, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_x_dense_index_][this->e2_v1_x_dense_index_] = d_edge2_v2_d_edge2_v1(0, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_x_dense_index_][this->e2_v1_y_dense_index_] = d_edge2_v2_d_edge2_v1(0, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_x_dense_index_][this->e2_v2_x_dense_index_] = d_edge2_v2_d_edge2_v2(0, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_x_dense_index_][this->e2_v2_y_dense_index_] = d_edge2_v2_d_edge2_v2(0, 1);
-
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_y_dense_index_][this->e1_v1_x_dense_index_] = d_edge2_v1_d_edge1_v1(1, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_y_dense_index_][this->e1_v1_y_dense_index_] = d_edge2_v1_d_edge1_v1(1, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_y_dense_index_][this->e1_v2_x_dense_index_] = d_edge2_v1_d_edge1_v2(1, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_y_dense_index_][this->e1_v2_y_dense_index_] = d_edge2_v1_d_edge1_v2(1, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_y_dense_index_][this->e2_v1_x_dense_index_] = d_edge2_v1_d_edge2_v1(1, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_y_dense_index_][this->e2_v1_y_dense_index_] = d_edge2_v1_d_edge2_v1(1, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_y_dense_index_][this->e2_v2_x_dense_index_] = d_edge2_v1_d_edge2_v2(1, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_y_dense_index_][this->e2_v2_y_dense_index_] = d_edge2_v1_d_edge2_v2(1, 1);
-
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_y_dense_index_][this->e1_v1_x_dense_index_] = d_edge2_v2_d_edge1_v1(1, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_y_dense_index_][this->e1_v1_y_dense_index_] = d_edge2_v2_d_edge1_v1(1, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_y_dense_index_][this->e1_v2_x_dense_index_] = d_edge2_v2_d_edge1_v2(1, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_y_dense_index_][this->e1_v2_y_dense_index_] = d_edge2_v2_d_edge1_v2(1, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_y_dense_index_][this->e2_v1_x_dense_index_] = d_edge2_v2_d_edge2_v1(1, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_y_dense_index_][this->e2_v1_y_dense_index_] = d_edge2_v2_d_edge2_v1(1, 1);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_y_dense_index_][this->e2_v2_x_dense_index_] = d_edge2_v2_d_edge2_v2(1, 0);
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_y_dense_index_][this->e2_v2_y_dense_index_] = d_edge2_v2_d_edge2_v2(1, 1);
+		this->second_derivative_values_ << d_edge1_scaled, d_edge1_scaled, d_edge2_scaled, d_edge2_scaled;
 	}
 	
 private:
 	/**
 	 * Private overrides
 	 */
-	void InitializeDenseIndexToFirstDerivativeSignMap(std::vector<double>& dense_index_to_first_derivative_sign_map) override
+	void InitializeFirstDerivativeSigns(LocalGradient& first_derivative_signs) override
 	{
-		dense_index_to_first_derivative_sign_map[this->e1_v1_x_dense_index_] = -1;
-		dense_index_to_first_derivative_sign_map[this->e1_v1_y_dense_index_] = -1;
-		dense_index_to_first_derivative_sign_map[this->e1_v2_x_dense_index_] =  1;
-		dense_index_to_first_derivative_sign_map[this->e1_v2_y_dense_index_] =  1;
-		dense_index_to_first_derivative_sign_map[this->e2_v1_x_dense_index_] =  1;
-		dense_index_to_first_derivative_sign_map[this->e2_v1_y_dense_index_] =  1;
-		dense_index_to_first_derivative_sign_map[this->e2_v2_x_dense_index_] = -1;
-		dense_index_to_first_derivative_sign_map[this->e2_v2_y_dense_index_] = -1;
+		first_derivative_signs << -1, -1, 1, 1, 1, 1, -1, -1;
 	}
 	
 	void CalculateValue(double& f) override
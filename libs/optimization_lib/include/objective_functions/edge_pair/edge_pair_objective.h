@@ -4,7 +4,6 @@
 
 // STL includes
 #include <utility>
-#include <unordered_map>
 
 // Optimization lib includes
 #include "../../core/core.h"
@@ -35,6 +34,15 @@ public:
 	}
 
 protected:
+	/**
+	 * Protected type definitions
+	 */
+
+	// Local derivatives are stored in the order of EdgePairDataProvider::LocalVariableIndex, so their size is known at compile time
+	static constexpr int LocalVariablesCount = EdgePairDataProvider::LocalVariableIndex::Count_;
+	using LocalGradient = Eigen::Matrix<double, LocalVariablesCount, 1>;
+	using LocalHessian = Eigen::Matrix<double, LocalVariablesCount, LocalVariablesCount>;
+
 	/**
 	 * Protected overrides
 	 */
@@ -43,66 +51,24 @@ protected:
 		SparseObjectiveFunction<StorageOrder_>::PostInitialize();
 
 		auto& edge_pair_data_provider = this->GetEdgePairDataProvider();
-		auto& dense_variable_index_to_sparse_variable_index_map = this->GetDenseVariableIndexToSparseVariableIndexMap();
-		auto& sparse_variable_index_to_dense_variable_index_map = this->GetSparseVariableIndexToDenseVariableIndexMap();
-
-		e1_v1_x_sparse_index_ = edge_pair_data_provider.GetEdge1Vertex1XIndex();
-		e1_v1_y_sparse_index_ = edge_pair_data_provider.GetEdge1Vertex1YIndex();
-		e1_v2_x_sparse_index_ = edge_pair_data_provider.GetEdge1Vertex2XIndex();
-		e1_v2_y_sparse_index_ = edge_pair_data_provider.GetEdge1Vertex2YIndex();
-		e2_v1_x_sparse_index_ = edge_pair_data_provider.GetEdge2Vertex1XIndex();
-		e2_v1_y_sparse_index_ = edge_pair_data_provider.GetEdge2Vertex1YIndex();
-		e2_v2_x_sparse_index_ = edge_pair_data_provider.GetEdge2Vertex2XIndex();
-		e2_v2_y_sparse_index_ = edge_pair_data_provider.GetEdge2Vertex2YIndex();
-
-		e1_v1_x_dense_index_ = sparse_variable_index_to_dense_variable_index_map.at(e1_v1_x_sparse_index_);
-		e1_v1_y_dense_index_ = sparse_variable_index_to_dense_variable_index_map.at(e1_v1_y_sparse_index_);
-		e1_v2_x_dense_index_ = sparse_variable_index_to_dense_variable_index_map.at(e1_v2_x_sparse_index_);
-		e1_v2_y_dense_index_ = sparse_variable_index_to_dense_variable_index_map.at(e1_v2_y_sparse_index_);
-		e2_v1_x_dense_index_ = sparse_variable_index_to_dense_variable_index_map.at(e2_v1_x_sparse_index_);
-		e2_v1_y_dense_index_ = sparse_variable_index_to_dense_variable_index_map.at(e2_v1_y_sparse_index_);
-		e2_v2_x_dense_index_ = sparse_variable_index_to_dense_variable_index_map.at(e2_v2_x_sparse_index_);
-		e2_v2_y_dense_index_ = sparse_variable_index_to_dense_variable_index_map.at(e2_v2_y_sparse_index_);
-		
-		dense_index_to_first_derivative_sign_map_.resize(this->objective_variables_count_);
-		InitializeDenseIndexToFirstDerivativeSignMap(dense_index_to_first_derivative_sign_map_);
-
-		dense_index_to_first_derivative_value_map_.resize(this->objective_variables_count_);
-		dense_indices_to_second_derivative_value_map_.resize(this->objective_variables_count_);
-		for (RDS::DenseVariableIndex i = 0; i < this->objective_variables_count_; i++)
+		const auto& variable_indices = edge_pair_data_provider.GetVariableIndices();
+		for (int32_t i = 0; i < LocalVariablesCount; i++)
 		{
-			dense_indices_to_second_derivative_value_map_[i].resize(this->objective_variables_count_);
-			for (RDS::DenseVariableIndex j = 0; j < this->objective_variables_count_; j++)
-			{
-				dense_indices_to_second_derivative_value_map_[i][j] = 0;
-			}
+			dense_variable_index_to_local_variable_index_.coeffRef(this->GetDenseVariableIndex(variable_indices.coeff(i))) = i;
 		}
+
+		InitializeFirstDerivativeSigns(first_derivative_signs_);
+		first_derivative_values_.setZero();
+		second_derivative_values_.setZero();
 	}
 
 	/**
 	 * Protected fields
 	 */
-	std::vector<double> dense_index_to_first_derivative_sign_map_;
-	std::vector<double> dense_index_to_first_derivative_value_map_;
-	std::vector<std::vector<double>> dense_indices_to_second_derivative_value_map_;
-
-	RDS::SparseVariableIndex e1_v1_x_sparse_index_;
-	RDS::SparseVariableIndex e1_v1_y_sparse_index_;
-	RDS::SparseVariableIndex e1_v2_x_sparse_index_;
-	RDS::SparseVariableIndex e1_v2_y_sparse_index_;
-	RDS::SparseVariableIndex e2_v1_x_sparse_index_;
-	RDS::SparseVariableIndex e2_v1_y_sparse_index_;
-	RDS::SparseVariableIndex e2_v2_x_sparse_index_;
-	RDS::SparseVariableIndex e2_v2_y_sparse_index_;
-
-	RDS::DenseVariableIndex e1_v1_x_dense_index_;
-	RDS::DenseVariableIndex e1_v1_y_dense_index_;
-	RDS::DenseVariableIndex e1_v2_x_dense_index_;
-	RDS::DenseVariableIndex e1_v2_y_dense_index_;
-	RDS::DenseVariableIndex e2_v1_x_dense_index_;
-	RDS::DenseVariableIndex e2_v1_y_dense_index_;
-	RDS::DenseVariableIndex e2_v2_x_dense_index_;
-	RDS::DenseVariableIndex e2_v2_y_dense_index_;
+
+	// First and second partial derivatives (up to the sign of the first derivative, see CalculateGradient() and CalculateRawTriplets())
+	LocalGradient first_derivative_values_;
+	LocalHessian second_derivative_values_;
 
 private:
 	/**
@@ -110,54 +76,53 @@ private:
 	 */
 	void InitializeSparseVariableIndices(std::vector<RDS::SparseVariableIndex>& sparse_variable_indices) override
 	{
-		auto& edge_pair_data_provider = GetEdgePairDataProvider();
-		sparse_variable_indices.push_back(edge_pair_data_provider.GetEdge1Vertex1XIndex());
-		sparse_variable_indices.push_back(edge_pair_data_provider.GetEdge1Vertex1YIndex());
-		sparse_variable_indices.push_back(edge_pair_data_provider.GetEdge1Vertex2XIndex());
-		sparse_variable_indices.push_back(edge_pair_data_provider.GetEdge1Vertex2YIndex());
-		sparse_variable_indices.push_back(edge_pair_data_provider.GetEdge2Vertex1XIndex());
-		sparse_variable_indices.push_back(edge_pair_data_provider.GetEdge2Vertex1YIndex());
-		sparse_variable_indices.push_back(edge_pair_data_provider.GetEdge2Vertex2XIndex());
-		sparse_variable_indices.push_back(edge_pair_data_provider.GetEdge2Vertex2YIndex());
+		const auto& variable_indices = GetEdgePairDataProvider().GetVariableIndices();
+		sparse_variable_indices.assign(variable_indices.data(), variable_indices.data() + LocalVariablesCount);
 	}
 
 	void CalculateGradient(Eigen::SparseVector<double>& g) override
 	{
-		auto objective_variable_count = this->objective_variables_count_;
-		auto dense_variable_index_to_sparse_variable_index_map = this->GetDenseVariableIndexToSparseVariableIndexMap();
-		for (RDS::DenseVariableIndex dense_variable_index = 0; dense_variable_index < objective_variable_count; dense_variable_index++)
-		{
-			const RDS::SparseVariableIndex sparse_variable_index = dense_variable_index_to_sparse_variable_index_map.at(dense_variable_index);
-			g.coeffRef(sparse_variable_index) = CalculateFirstPartialDerivative(dense_variable_index);
-		}
+		// Empty implementation (the gradient is expanded from the local gradient, see CalculateLocalGradient())
+	}
+
+	// The local gradient is stored in the order of EdgePairDataProvider::LocalVariableIndex
+	void InitializeLocalGradient(std::vector<RDS::SparseVariableIndex>& local_gradient_indices) override
+	{
+		const auto& variable_indices = GetEdgePairDataProvider().GetVariableIndices();
+		local_gradient_indices.assign(variable_indices.data(), variable_indices.data() + LocalVariablesCount);
+	}
+
+	void CalculateLocalGradient(Eigen::VectorXd& local_g) override
+	{
+		local_g = first_derivative_signs_.cwiseProduct(first_derivative_values_);
 	}
 
 	void CalculateRawTriplets(std::vector<Eigen::Triplet<double>>& triplets) override
 	{
-		const auto triplets_count = triplets.size();
-		auto sparse_variable_index_to_dense_variable_index_map = this->GetSparseVariableIndexToDenseVariableIndexMap();
-		for (RDS::HessianTripletIndex i = 0; i < triplets_count; i++)
+		const LocalHessian local_hessian = first_derivative_signs_.asDiagonal() * second_derivative_values_;
+
+		// The triplets are laid out as the column-major upper triangle of the local hessian, in dense (sorted) variable order
+		for (RDS::DenseVariableIndex column = 0; column < LocalVariablesCount; column++)
 		{
-			auto dense_variable_index1 = sparse_variable_index_to_dense_variable_index_map[triplets[i].row()];
-			auto dense_variable_index2 = sparse_variable_index_to_dense_variable_index_map[triplets[i].col()];
-			const_cast<double&>(triplets[i].value()) = CalculateSecondPartialDerivative(dense_variable_index1, dense_variable_index2);
+			const int32_t local_column = dense_variable_index_to_local_variable_index_.coeff(column);
+			for (RDS::DenseVariableIndex row = 0; row <= column; row++)
+			{
+				const int32_t local_row = dense_variable_index_to_local_variable_index_.coeff(row);
+				const_cast<double&>(triplets[this->GetHessianTripletIndex(row, column)].value()) = local_hessian.coeff(local_row, local_column);
+			}
 		}
 	}
 
 	/**
 	 * Private methods
 	 */
-	virtual void InitializeDenseIndexToFirstDerivativeSignMap(std::vector<double>& dense_index_to_first_derivative_sign_map) = 0;
-	
-	double CalculateFirstPartialDerivative(const RDS::SparseVariableIndex dense_variable_index)
-	{
-		return dense_index_to_first_derivative_sign_map_[dense_variable_index] * dense_index_to_first_derivative_value_map_[dense_variable_index];
-	}
+	virtual void InitializeFirstDerivativeSigns(LocalGradient& first_derivative_signs) = 0;
 
-	double CalculateSecondPartialDerivative(const RDS::SparseVariableIndex dense_variable_index1, const RDS::SparseVariableIndex dense_variable_index2)
-	{
-		return dense_index_to_first_derivative_sign_map_[dense_variable_index1] * dense_indices_to_second_derivative_value_map_[dense_variable_index1][dense_variable_index2];
-	}
+	/**
+	 * Private fields
+	 */
+	LocalGradient first_derivative_signs_;
+	Eigen::Matrix<int32_t, LocalVariablesCount, 1> dense_variable_index_to_local_variable_index_;
 };
 
 #endif
\ No newline at end of file
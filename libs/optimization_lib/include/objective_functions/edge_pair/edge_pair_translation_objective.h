@@ -28,6 +28,12 @@ public:
 	}
 
 protected:
+	/**
+	 * Protected type definitions
+	 */
+	using EdgePairObjective<StorageOrder_>::LocalVariablesCount;
+	using typename EdgePairObjective<StorageOrder_>::LocalGradient;
+
 	/**
 	 * Protected overrides
 	 */
@@ -45,73 +51,26 @@ protected:
 		/**
 		 * First partial derivatives
 		 */
-		this->dense_index_to_first_derivative_value_map_[this->e1_v1_x_dense_index_] = x_cross_diff_doubled_;
-		this->dense_index_to_first_derivative_value_map_[this->e1_v1_y_dense_index_] = y_cross_diff_doubled_;
-		this->dense_index_to_first_derivative_value_map_[this->e1_v2_x_dense_index_] = x_cross_diff_doubled_;
-		this->dense_index_to_first_derivative_value_map_[this->e1_v2_y_dense_index_] = y_cross_diff_doubled_;
-		this->dense_index_to_first_derivative_value_map_[this->e2_v1_x_dense_index_] = x_cross_diff_doubled_;
-		this->dense_index_to_first_derivative_value_map_[this->e2_v1_y_dense_index_] = y_cross_diff_doubled_;
-		this->dense_index_to_first_derivative_value_map_[this->e2_v2_x_dense_index_] = x_cross_diff_doubled_;
-		this->dense_index_to_first_derivative_value_map_[this->e2_v2_y_dense_index_] = y_cross_diff_doubled_;
+		this->first_derivative_values_ <<
+			x_cross_diff_doubled_, y_cross_diff_doubled_, x_cross_diff_doubled_, y_cross_diff_doubled_,
+			x_cross_diff_doubled_, y_cross_diff_doubled_, x_cross_diff_doubled_, y_cross_diff_doubled_;
 
 		/**
-		 * Second partial derivatives
+		 * Second partial derivatives (x and y coordinates are decoupled, and all rows are the same)
 		 */
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_x_dense_index_][this->e1_v1_x_dense_index_] = 2;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_x_dense_index_][this->e1_v2_x_dense_index_] = -2;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_x_dense_index_][this->e2_v1_x_dense_index_] = -2;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_x_dense_index_][this->e2_v2_x_dense_index_] = 2;
-
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_x_dense_index_][this->e1_v1_x_dense_index_] = 2;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_x_dense_index_][this->e1_v2_x_dense_index_] = -2;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_x_dense_index_][this->e2_v1_x_dense_index_] = -2;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_x_dense_index_][this->e2_v2_x_dense_index_] = 2;
-
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_y_dense_index_][this->e1_v1_y_dense_index_] = 2;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_y_dense_index_][this->e1_v2_y_dense_index_] = -2;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_y_dense_index_][this->e2_v1_y_dense_index_] = -2;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v1_y_dense_index_][this->e2_v2_y_dense_index_] = 2;
-
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_y_dense_index_][this->e1_v1_y_dense_index_] = 2;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_y_dense_index_][this->e1_v2_y_dense_index_] = -2;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_y_dense_index_][this->e2_v1_y_dense_index_] = -2;
-		this->dense_indices_to_second_derivative_value_map_[this->e1_v2_y_dense_index_][this->e2_v2_y_dense_index_] = 2;
-
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_x_dense_index_][this->e1_v1_x_dense_index_] = 2;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_x_dense_index_][this->e1_v2_x_dense_index_] = -2;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_x_dense_index_][this->e2_v1_x_dense_index_] = -2;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_x_dense_index_][this->e2_v2_x_dense_index_] = 2;
-
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_x_dense_index_][this->e1_v1_x_dense_index_] = 2;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_x_dense_index_][this->e1_v2_x_dense_index_] = -2;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_x_dense_index_][this->e2_v1_x_dense_index_] = -2;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_x_dense_index_][this->e2_v2_x_dense_index_] = 2;
-
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_y_dense_index_][this->e1_v1_y_dense_index_] = 2;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_y_dense_index_][this->e1_v2_y_dense_index_] = -2;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_y_dense_index_][this->e2_v1_y_dense_index_] = -2;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v1_y_dense_index_][this->e2_v2_y_dense_index_] = 2;
-
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_y_dense_index_][this->e1_v1_y_dense_index_] = 2;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_y_dense_index_][this->e1_v2_y_dense_index_] = -2;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_y_dense_index_][this->e2_v1_y_dense_index_] = -2;
-		this->dense_indices_to_second_derivative_value_map_[this->e2_v2_y_dense_index_][this->e2_v2_y_dense_index_] = 2;
+		const Eigen::Matrix2d I2 = 2 * Eigen::Matrix2d::Identity();
+		Eigen::Matrix<double, 2, LocalVariablesCount> d_cross_diff_doubled;
+		d_cross_diff_doubled << I2, -I2, -I2, I2;
+		this->second_derivative_values_ << d_cross_diff_doubled, d_cross_diff_doubled, d_cross_diff_doubled, d_cross_diff_doubled;
 	}
 
 private:
 	/**
 	 * Private overrides
 	 */
-	void InitializeDenseIndexToFirstDerivativeSignMap(std::vector<double>& dense_index_to_first_derivative_sign_map) override
+	void InitializeFirstDerivativeSigns(LocalGradient& first_derivative_signs) override
 	{
-		dense_index_to_first_derivative_sign_map[this->e1_v1_x_dense_index_] = 1;
-		dense_index_to_first_derivative_sign_map[this->e1_v1_y_dense_index_] = 1;
-		dense_index_to_first_derivative_sign_map[this->e1_v2_x_dense_index_] = -1;
-		dense_index_to_first_derivative_sign_map[this->e1_v2_y_dense_index_] = -1;
-		dense_index_to_first_derivative_sign_map[this->e2_v1_x_dense_index_] = -1;
-		dense_index_to_first_derivative_sign_map[this->e2_v1_y_dense_index_] = -1;
-		dense_index_to_first_derivative_sign_map[this->e2_v2_x_dense_index_] = 1;
-		dense_index_to_first_derivative_sign_map[this->e2_v2_y_dense_index_] = 1;
+		first_derivative_signs << 1, 1, -1, -1, -1, -1, 1, 1;
 	}
 
 	void CalculateValue(double& f) override
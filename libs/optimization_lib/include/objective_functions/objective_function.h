@@ -9,11 +9,18 @@
 #include <mutex>
 #include <any>
 #include <limits>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
 
 // Eigen Includes
 #include <Eigen/Core>
 #include <Eigen/Sparse>
 
+// TBB includes
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
 // Optimization Lib Includes
 #include "../core/core.h"
 #include "../core/updatable_object.h"
@@ -37,10 +44,21 @@ public:
 	 */
 	ObjectiveFunction(const std::shared_ptr<MeshDataProvider>& mesh_data_provider, const std::shared_ptr<DataProvider>& data_provider, const std::string& name) :
 		ObjectiveFunctionBase(mesh_data_provider),
+		data_provider_(data_provider),
 		f_(0),
+		value_per_vertex_stale_(false),
+		value_per_edge_stale_(false),
+		value_per_vertex_subscribed_(false),
+		value_per_edge_subscribed_(false),
+		diagnostics_publication_pending_(false),
+		persistent_hessian_pattern_enabled_(true),
+		hessian_pattern_initialized_(false),
+		hessian_pattern_version_(0),
+		stale_hessian_entries_count_(0),
+		hessian_entries_blocks_patchable_(false),
+		mapped_hessian_entries_layout_version_(0),
 		w_(1),
-		name_(name),
-		data_provider_(data_provider)
+		name_(name)
 	{
 		if (std::dynamic_pointer_cast<EmptyDataProvider>(data_provider_) == nullptr)
 		{
@@ -61,29 +79,87 @@ public:
 		return f_;
 	}
 
-	const VectorType_& GetValuePerVertex() const
+	// Values per vertex and per edge are diagnostics, so they are calculated (for the latest value update) only once they are read
+	const VectorType_& GetValuePerVertex()
 	{
+		RefreshValuePerVertex();
 		return f_per_vertex_;
 	}
 
-	const Eigen::VectorXd& GetImageValuePerEdge() const
+	const Eigen::VectorXd& GetImageValuePerEdge()
 	{
+		RefreshValuePerEdge();
 		return image_value_per_edge_;
 	}
 
-	const Eigen::VectorXd& GetDomainValuePerEdge() const
+	const Eigen::VectorXd& GetDomainValuePerEdge()
 	{
+		RefreshValuePerEdge();
 		return domain_value_per_edge_;
 	}
 
+	// Threads other than the iteration thread (e.g., the UI) read the values per vertex and per edge published between iterations (see PublishDiagnostics()),
+	// so they never wait for an iteration to complete. Reading them subscribes to their publication, and they are zero until first published.
+	VectorType_ GetPublishedValuePerVertex()
+	{
+		value_per_vertex_subscribed_ = true;
+		std::lock_guard<std::mutex> lock(published_diagnostics_mutex_);
+		if (published_f_per_vertex_.size() != mesh_data_provider_->GetImageVerticesCount())
+		{
+			InitializeValuePerVertex(published_f_per_vertex_);
+		}
+
+		return published_f_per_vertex_;
+	}
+
+	Eigen::VectorXd GetPublishedValuePerEdge(const ObjectiveFunctionBase::PropertyModifiers property_modifiers)
+	{
+		auto lock = LockPublishedValuePerEdge();
+		switch (property_modifiers)
+		{
+		case ObjectiveFunctionBase::PropertyModifiers::Domain:
+			if (published_domain_value_per_edge_.size() == 0)
+			{
+				return Eigen::VectorXd::Zero(mesh_data_provider_->GetDomainEdgesCount());
+			}
+			return published_domain_value_per_edge_;
+		case ObjectiveFunctionBase::PropertyModifiers::Image:
+			if (published_image_value_per_edge_.size() == 0)
+			{
+				return Eigen::VectorXd::Zero(mesh_data_provider_->GetImageEdgesCount());
+			}
+			return published_image_value_per_edge_;
+		}
+
+		return Eigen::VectorXd();
+	}
+
+	// Objectives with a local gradient do not keep a full gradient, and expand their local gradient into one only when it is read
 	const VectorType_& GetGradient() const
 	{
+		if (!local_gradient_indices_.empty())
+		{
+			ExpandLocalGradient();
+		}
+
 		return g_;
 	}
 
 	const Eigen::SparseMatrix<double, StorageOrder_>& GetHessian()
 	{
-		H_.setFromTriplets(triplets_.begin(), triplets_.end());
+		if (!persistent_hessian_pattern_enabled_ || !hessian_pattern_initialized_)
+		{
+			InitializeHessianPattern();
+		}
+		else if (mapped_hessian_entries_layout_version_ != GetHessianEntriesLayoutVersion() || hessian_entry_values_.size() != GetHessianEntriesCount())
+		{
+			UpdateHessianPattern();
+		}
+		else
+		{
+			AssembleHessian();
+		}
+
 		return H_;
 	}
 
@@ -92,6 +168,12 @@ public:
 		return triplets_;
 	}
 
+	// Incremented whenever the compressed structure of the hessian is rebuilt
+	std::size_t GetHessianPatternVersion() const
+	{
+		return hessian_pattern_version_;
+	}
+
 	double GetWeight() const
 	{
 		return w_;
@@ -118,10 +200,10 @@ public:
 			property_value = GetValue();
 			return true;
 		case Properties::ValuePerVertex:
-			property_value = GetValuePerVertex();
+			property_value = GetPublishedValuePerVertex();
 			return true;
 		case Properties::ValuePerEdge:
-			property_value = GetValuePerEdge(property_modifiers);
+			property_value = GetPublishedValuePerEdge(property_modifiers);
 			return true;		
 		case Properties::Gradient:
 			property_value = GetGradient();
@@ -130,7 +212,7 @@ public:
 			property_value = GetHessian();
 			return true;
 		case Properties::GradientNorm:
-			property_value = GetGradient().norm();
+			property_value = local_gradient_indices_.empty() ? GetGradient().norm() : local_g_.norm();
 			return true;
 		case Properties::Weight:
 			property_value = GetWeight();
@@ -148,12 +230,38 @@ public:
 	 */
 	void SetWeight(const double w)
 	{
+		// Zero-weight objectives are pruned from the dependency layers, so they have to be rebuilt whenever a weight becomes (or stops being) zero
+		if ((w_ == 0) != (w == 0))
+		{
+			UpdatableObject::InvalidateDependencyLayers();
+		}
+
+		if (w_ != w)
+		{
+			ObjectiveFunctionBase::InvalidateDefinition();
+		}
+
 		w_ = w;
 	}
 
+	// When enabled, the compressed structure of the hessian is built once and each hessian entry is mapped to its slot in H_.valuePtr()
+	void EnablePersistentHessianPattern()
+	{
+		persistent_hessian_pattern_enabled_ = true;
+		hessian_pattern_initialized_ = false;
+	}
+
+	void DisablePersistentHessianPattern()
+	{
+		persistent_hessian_pattern_enabled_ = false;
+		hessian_pattern_initialized_ = false;
+	}
+
 	// Generic property setter
+	// Derived objective functions forward every property to this implementation first, so any property set changes the definition version
 	virtual bool SetProperty(const int32_t property_id, const std::any property_context, const std::any property_value) override
 	{
+		ObjectiveFunctionBase::InvalidateDefinition();
 		const Properties properties = static_cast<Properties>(property_id);
 		switch (properties)
 		{
@@ -175,11 +283,20 @@ public:
 		std::lock_guard<std::mutex> lock(mutex_);
 		PreInitialize();
 		InitializeValue(f_);
-		InitializeValuePerVertex(f_per_vertex_);
-		InitializeValuePerEdge(image_value_per_edge_, domain_value_per_edge_);
-		InitializeGradient(g_);
+		local_gradient_indices_.clear();
+		InitializeLocalGradient(local_gradient_indices_);
+		local_g_.setZero(local_gradient_indices_.size());
+		if (local_gradient_indices_.empty())
+		{
+			InitializeGradient(g_);
+		}
+		else
+		{
+			g_.resize(0);
+		}
 		InitializeHessian(H_);
 		InitializeTriplets(triplets_);
+		hessian_pattern_initialized_ = false;
 		PostInitialize();
 		UpdatableObject::Initialize();
 	}
@@ -192,28 +309,39 @@ public:
 	
 	void Update(const Eigen::VectorXd& x, const int32_t update_modifiers) override
 	{
-		PreUpdate(x);
-
 		const UpdateOptions update_options = static_cast<UpdateOptions>(update_modifiers);
 
+		PreUpdate(x, update_options);
+
 		if ((update_options & UpdateOptions::Value) != UpdateOptions::None)
 		{
 			CalculateValue(f_);
+			value_per_vertex_stale_ = true;
+			value_per_edge_stale_ = true;
 		}
 
 		if ((update_options & UpdateOptions::ValuePerVertex) != UpdateOptions::None)
 		{
-			CalculateValuePerVertex(f_per_vertex_);
+			value_per_vertex_stale_ = true;
+			RefreshValuePerVertex();
 		}
 
 		if ((update_options & UpdateOptions::ValuePerEdge) != UpdateOptions::None)
 		{
-			CalculateValuePerEdge(domain_value_per_edge_, image_value_per_edge_);
+			value_per_edge_stale_ = true;
+			RefreshValuePerEdge();
 		}
 
 		if ((update_options & UpdateOptions::Gradient) != UpdateOptions::None)
 		{
-			CalculateGradient(g_);
+			if (local_gradient_indices_.empty())
+			{
+				CalculateGradient(g_);
+			}
+			else
+			{
+				CalculateLocalGradient(local_g_);
+			}
 		}
 
 		if ((update_options & UpdateOptions::Hessian) != UpdateOptions::None)
@@ -232,60 +360,72 @@ public:
 	void UpdateLayers(const Eigen::VectorXd& x, const UpdateOptions update_options)
 	{
 		std::lock_guard<std::mutex> lock(mutex_);
-		int32_t update_modifiers = static_cast<int32_t>(update_options);
-		const auto layers_count = dependency_layers_.size();
-		for(std::size_t current_layer_index = 0; current_layer_index < layers_count; current_layer_index++)
-		{
-			const auto& current_layer = dependency_layers_[current_layer_index];
-			const auto objects_count = current_layer.size();
+		const int32_t update_modifiers = static_cast<int32_t>(update_options);
+		this->UpdateDependencies(x, update_modifiers);
+		Update(x, update_modifiers);
+	}
 
-			// HACK: Remove this 'if' branch once Separation and Symmetric Dirichlet
-			// objectives are composed as sum of sub-objectives
-			if(current_layer_index == 0)
-			{
-				#pragma omp parallel for
-				for (long i = 1; i < objects_count; i++)
-				{
-					current_layer[i]->Update(x, update_modifiers);
-				}
+	// Marks a publication of the diagnostics as pending, and returns whether it was not pending already (so callers post a single publication at a time)
+	bool RequestDiagnosticsPublication()
+	{
+		return !diagnostics_publication_pending_.exchange(true);
+	}
 
-				if (objects_count > 0)
-				{
-					current_layer[0]->Update(x, update_modifiers);
-				}
+	// Calculates the subscribed values per vertex and per edge (for the latest value update), and publishes them. Must be called on the iteration
+	// thread, between iterations (see IterativeMethod::RunBetweenIterations()).
+	void PublishDiagnostics()
+	{
+		diagnostics_publication_pending_ = false;
+		const bool publish_value_per_vertex = value_per_vertex_subscribed_;
+		const bool publish_value_per_edge = value_per_edge_subscribed_;
+		if (publish_value_per_vertex)
+		{
+			RefreshValuePerVertex();
+		}
 
-				//if (objects_count > 1)
-				//{
-				//	current_layer[1]->Update(x, update_modifiers);
-				//}
-			}
-			else
-			{
-				#pragma omp parallel for
-				for (long i = 0; i < objects_count; i++)
-				{
-					current_layer[i]->Update(x, update_modifiers);
-				}
-			}
+		if (publish_value_per_edge)
+		{
+			RefreshValuePerEdge();
 		}
 
-		Update(x, update_modifiers);
+		std::lock_guard<std::mutex> lock(published_diagnostics_mutex_);
+		if (publish_value_per_vertex)
+		{
+			published_f_per_vertex_ = f_per_vertex_;
+		}
+
+		if (publish_value_per_edge)
+		{
+			PublishValuePerEdge();
+		}
 	}
 
 	template<typename ValueVectorType_>
-	void AddValuePerVertex(ValueVectorType_& f_per_vertex, const double w = 1) const
+	void AddValuePerVertex(ValueVectorType_& f_per_vertex, const double w = 1)
 	{
-		f_per_vertex = f_per_vertex + w * f_per_vertex_;
+		f_per_vertex = f_per_vertex + w * GetValuePerVertex();
 	}
 
 	template<typename GradientVectorType_>
 	void AddGradient(GradientVectorType_& g, const double w = 1) const
 	{
+		// Objectives with a local gradient scatter only their own entries
+		if (!local_gradient_indices_.empty())
+		{
+			const int64_t local_gradient_size = local_gradient_indices_.size();
+			for (int64_t i = 0; i < local_gradient_size; i++)
+			{
+				g.coeffRef(local_gradient_indices_[i]) += w * local_g_.coeff(i);
+			}
+
+			return;
+		}
+
 		g = g + w * g_;
 	}
 
 	template<typename ValueVectorType_>
-	void AddValuePerVertexSafe(ValueVectorType_& f_per_vertex, const double w = 1) const
+	void AddValuePerVertexSafe(ValueVectorType_& f_per_vertex, const double w = 1)
 	{
 		AddValuePerVertex(f_per_vertex, w);
 	}
@@ -296,7 +436,7 @@ public:
 		AddGradient(g, w);
 	}
 
-	virtual void AddTriplets(std::vector<Eigen::Triplet<double>>& triplets, const double w = 1) const
+	void AddTriplets(std::vector<Eigen::Triplet<double>>& triplets, const double w = 1) const override
 	{
 		const int64_t start_index = triplets.size();
 		const int64_t end_index = start_index + triplets_.size();
@@ -308,6 +448,58 @@ public:
 		}
 	}
 
+	// Number of hessian entries contributed by this objective, in the order they are emitted by AddTriplets() and AddHessianEntries()
+	virtual std::size_t GetHessianEntriesCount() const
+	{
+		return triplets_.size();
+	}
+
+	// Objectives that emit their own hessian entries make up a single block
+	void AddHessianEntriesBlocks(std::vector<HessianEntriesBlock>& hessian_entries_blocks) const override
+	{
+		hessian_entries_blocks.push_back({ this, GetHessianEntriesCount(), GetHessianEntriesLayoutVersion() });
+	}
+
+	// Writes the weighted hessian entries of this objective into a contiguous block of the root's entry values buffer.
+	// Each objective owns its block exclusively, so independent objectives can write their entries concurrently.
+	virtual void AddHessianEntries(double* entry_values, const double w = 1) const
+	{
+		const int64_t triplets_count = triplets_.size();
+		for (int64_t i = 0; i < triplets_count; i++)
+		{
+			entry_values[i] = w * triplets_[i].value();
+		}
+	}
+
+	// Accumulates the weighted product of the hessian with a given vector, using the local hessian entries of this objective (no global hessian is assembled).
+	// Hessian entries are stored as an upper triangle, so every off-diagonal entry contributes to both of its symmetric positions.
+	virtual void AddHessianVectorProduct(const Eigen::VectorXd& v, Eigen::VectorXd& Hv, const double w = 1) const
+	{
+		for (const auto& triplet : triplets_)
+		{
+			const auto row = triplet.row();
+			const auto col = triplet.col();
+			const double value = w * triplet.value();
+			Hv.coeffRef(row) += value * v.coeff(col);
+			if (row != col)
+			{
+				Hv.coeffRef(col) += value * v.coeff(row);
+			}
+		}
+	}
+
+	// Accumulates the weighted diagonal of the hessian
+	virtual void AddHessianDiagonal(Eigen::VectorXd& diagonal, const double w = 1) const
+	{
+		for (const auto& triplet : triplets_)
+		{
+			if (triplet.row() == triplet.col())
+			{
+				diagonal.coeffRef(triplet.row()) += w * triplet.value();
+			}
+		}
+	}
+
 	/**
 	 * Gradient and hessian approximation using finite differences
 	 */
@@ -394,11 +586,58 @@ protected:
 		// Empty implementation
 	}
 
+	// Lets objectives that evaluate several quantities in a single (fused) pass skip the work of quantities that were not requested
+	virtual void PreUpdate(const Eigen::VectorXd& x, const UpdateOptions update_options)
+	{
+		PreUpdate(x);
+	}
+
 	virtual void PostUpdate(const Eigen::VectorXd& x)
 	{
 		// Empty implementation
 	}
 
+	// Calculates the value per vertex if the value was updated since it was last calculated
+	void RefreshValuePerVertex()
+	{
+		// The value per vertex buffer is allocated only once it is first read
+		if (f_per_vertex_.size() != mesh_data_provider_->GetImageVerticesCount())
+		{
+			InitializeValuePerVertex(f_per_vertex_);
+		}
+
+		if (value_per_vertex_stale_)
+		{
+			CalculateValuePerVertex(f_per_vertex_);
+			value_per_vertex_stale_ = false;
+		}
+	}
+
+	// Calculates the values per edge if the value was updated since they were last calculated
+	void RefreshValuePerEdge()
+	{
+		if (value_per_edge_stale_)
+		{
+			CalculateValuePerEdge(domain_value_per_edge_, image_value_per_edge_);
+			value_per_edge_stale_ = false;
+		}
+	}
+
+	// Copies the values per edge to their published buffers, under the lock of the published diagnostics. Objectives that calculate more
+	// values per edge publish them as well.
+	virtual void PublishValuePerEdge()
+	{
+		published_domain_value_per_edge_ = domain_value_per_edge_;
+		published_image_value_per_edge_ = image_value_per_edge_;
+	}
+
+	// Subscribes to the publication of the values per edge, and locks their published buffers for reading
+	std::unique_lock<std::mutex> LockPublishedValuePerEdge()
+	{
+		value_per_edge_subscribed_ = true;
+		return std::unique_lock<std::mutex>(published_diagnostics_mutex_);
+	}
+
 	/**
 	 * Protected fields
 	 */
@@ -410,21 +649,31 @@ protected:
 	std::shared_ptr<DataProvider> data_provider_;
 	
 private:
-
 	/**
-	 * Private getters
+	 * Private type definitions
 	 */
-	
-	const Eigen::VectorXd& GetValuePerEdge(const ObjectiveFunctionBase::PropertyModifiers property_modifiers) const
+
+	// A hessian entry, addressed by the block it belongs to and its index within that block (so the entries of a block can move
+	// within the entry values buffer without being remapped)
+	struct HessianEntryReference
 	{
-		switch (property_modifiers)
-		{
-		case ObjectiveFunctionBase::PropertyModifiers::Domain:
-			return GetDomainValuePerEdge();
-		case ObjectiveFunctionBase::PropertyModifiers::Image:
-			return GetImageValuePerEdge();
-		}
-	}
+		int64_t block_index;
+		int64_t entry_index;
+	};
+
+	struct MappedHessianEntriesBlock
+	{
+		int64_t block_index;
+		std::size_t entries_count;
+		std::size_t entries_layout_version;
+	};
+
+	// A hessian entry that was mapped after the value-to-entries map was built (see PatchHessianEntries())
+	struct PatchedHessianEntry
+	{
+		int64_t value_index;
+		HessianEntryReference entry_reference;
+	};
 
 	/**
 	 * Private methods
@@ -442,15 +691,6 @@ private:
 		f_per_vertex.setZero();
 	}
 
-	void InitializeValuePerEdge(Eigen::VectorXd& image_value_per_edge, Eigen::VectorXd& domain_value_per_edge)
-	{
-		domain_value_per_edge.resize(mesh_data_provider_->GetDomainEdgesCount());
-		domain_value_per_edge.setZero();
-		
-		image_value_per_edge.resize(mesh_data_provider_->GetImageEdgesCount());
-		image_value_per_edge.setZero();
-	}
-
 	void InitializeGradient(VectorType_& g)
 	{
 		g.resize(mesh_data_provider_->GetVariablesCount());
@@ -465,6 +705,298 @@ private:
 
 	virtual void InitializeTriplets(std::vector<Eigen::Triplet<double>>& triplets) = 0;
 
+	// Builds the compressed hessian structure from the current hessian entries and maps each entry to its destination in H_.valuePtr()
+	void InitializeHessianPattern()
+	{
+		std::vector<Eigen::Triplet<double>> triplets;
+		triplets.reserve(GetHessianEntriesCount());
+		AddTriplets(triplets);
+		InitializeHessianPattern(triplets);
+	}
+
+	// The compressed structure is upper triangular and has an explicit diagonal (as expected by symmetric solvers, e.g., pardiso with mtype = 2),
+	// so solvers may use the buffers of H_ as is. Entries below the diagonal are folded into their upper triangle counterparts.
+	void InitializeHessianPattern(const std::vector<Eigen::Triplet<double>>& triplets)
+	{
+		const int64_t variables_count = H_.rows();
+		std::vector<Eigen::Triplet<double>> pattern_triplets;
+		pattern_triplets.reserve(triplets.size() + variables_count);
+		for (const auto& triplet : triplets)
+		{
+			pattern_triplets.emplace_back(std::min(triplet.row(), triplet.col()), std::max(triplet.row(), triplet.col()), 0);
+		}
+
+		for (int64_t i = 0; i < variables_count; i++)
+		{
+			pattern_triplets.emplace_back(i, i, 0);
+		}
+
+		H_.setFromTriplets(pattern_triplets.begin(), pattern_triplets.end());
+		H_.makeCompressed();
+		MapHessianEntries(triplets);
+		AssembleHessian();
+		hessian_pattern_initialized_ = true;
+		hessian_pattern_version_++;
+	}
+
+	// Remaps the hessian entries after children were added or removed. Only the blocks of entries that were added or changed are mapped
+	// (see PatchHessianEntries()), and the entries of the whole tree are remapped only once enough of the map went stale. When all entries
+	// fall within the current compressed structure (e.g., a position constraint over a face that is already coupled), the structure and
+	// its version are kept, so solvers do not have to repeat their symbolic analysis.
+	void UpdateHessianPattern()
+	{
+		if (!PatchHessianEntries())
+		{
+			std::vector<Eigen::Triplet<double>> triplets;
+			triplets.reserve(GetHessianEntriesCount());
+			AddTriplets(triplets);
+			if (!MapHessianEntries(triplets))
+			{
+				InitializeHessianPattern(triplets);
+				return;
+			}
+		}
+
+		AssembleHessian();
+	}
+
+	// Returns the index of the slot of a hessian entry in H_.valuePtr(), or -1 if it has no slot
+	int64_t FindHessianValueIndex(const Eigen::Triplet<double>& triplet) const
+	{
+		const auto* outer_index_ptr = H_.outerIndexPtr();
+		const auto* inner_index_ptr = H_.innerIndexPtr();
+		const auto row = std::min(triplet.row(), triplet.col());
+		const auto col = std::max(triplet.row(), triplet.col());
+		const auto outer_index = H_.IsRowMajor ? row : col;
+		const auto inner_index = H_.IsRowMajor ? col : row;
+		const auto* begin = inner_index_ptr + outer_index_ptr[outer_index];
+		const auto* end = inner_index_ptr + outer_index_ptr[outer_index + 1];
+		const auto* inner_index_it = std::lower_bound(begin, end, inner_index);
+		if (inner_index_it == end || *inner_index_it != inner_index)
+		{
+			return -1;
+		}
+
+		return inner_index_it - inner_index_ptr;
+	}
+
+	// Maps each hessian entry to its slot in H_.valuePtr(). Returns false (and leaves the current mapping as is) if an entry has no slot.
+	bool MapHessianEntries(const std::vector<Eigen::Triplet<double>>& triplets)
+	{
+		const std::size_t hessian_entries_layout_version = GetHessianEntriesLayoutVersion();
+		const int64_t triplets_count = triplets.size();
+		const int64_t values_count = H_.nonZeros();
+		std::vector<int64_t> triplet_to_value_index_map(triplets_count);
+		for (int64_t i = 0; i < triplets_count; i++)
+		{
+			triplet_to_value_index_map[i] = FindHessianValueIndex(triplets[i]);
+			if (triplet_to_value_index_map[i] < 0)
+			{
+				return false;
+			}
+		}
+
+		// Address each entry by its block. If the blocks do not make up the entries (or an objective appears more than once),
+		// all entries are addressed as a single block, and later layout changes are always mapped from scratch.
+		std::vector<HessianEntriesBlock> hessian_entries_blocks;
+		AddHessianEntriesBlocks(hessian_entries_blocks);
+		std::unordered_map<const ObjectiveFunctionBase*, MappedHessianEntriesBlock> mapped_hessian_entries_blocks;
+		mapped_hessian_entries_blocks.reserve(hessian_entries_blocks.size());
+		std::size_t blocks_entries_count = 0;
+		bool hessian_entries_blocks_patchable = true;
+		for (int64_t i = 0; i < static_cast<int64_t>(hessian_entries_blocks.size()) && hessian_entries_blocks_patchable; i++)
+		{
+			const auto& hessian_entries_block = hessian_entries_blocks[i];
+			hessian_entries_blocks_patchable = mapped_hessian_entries_blocks.emplace(hessian_entries_block.objective_function, MappedHessianEntriesBlock{ i, hessian_entries_block.entries_count, hessian_entries_block.entries_layout_version }).second;
+			blocks_entries_count += hessian_entries_block.entries_count;
+		}
+
+		if (!hessian_entries_blocks_patchable || blocks_entries_count != triplets_count)
+		{
+			hessian_entries_blocks = { { this, static_cast<std::size_t>(triplets_count), hessian_entries_layout_version } };
+			mapped_hessian_entries_blocks.clear();
+			hessian_entries_blocks_patchable = false;
+		}
+
+		std::vector<int64_t> hessian_entries_block_offsets(hessian_entries_blocks.size());
+		std::vector<HessianEntryReference> entry_references(triplets_count);
+		int64_t entries_offset = 0;
+		for (int64_t i = 0; i < static_cast<int64_t>(hessian_entries_blocks.size()); i++)
+		{
+			hessian_entries_block_offsets[i] = entries_offset;
+			const int64_t entries_count = hessian_entries_blocks[i].entries_count;
+			for (int64_t j = 0; j < entries_count; j++)
+			{
+				entry_references[entries_offset + j] = { i, j };
+			}
+
+			entries_offset += entries_count;
+		}
+
+		// Transpose the entry-to-value map into a compressed value-to-entries map. Entries of each value are kept in emission order,
+		// so every value is always summed in the same order, regardless of the number of threads.
+		value_to_entries_outer_index_.assign(values_count + 1, 0);
+		for (int64_t i = 0; i < triplets_count; i++)
+		{
+			value_to_entries_outer_index_[triplet_to_value_index_map[i] + 1]++;
+		}
+
+		for (int64_t i = 0; i < values_count; i++)
+		{
+			value_to_entries_outer_index_[i + 1] += value_to_entries_outer_index_[i];
+		}
+
+		value_to_entries_inner_index_.resize(triplets_count);
+		std::vector<int64_t> value_insertion_index(value_to_entries_outer_index_.begin(), value_to_entries_outer_index_.end() - 1);
+		for (int64_t i = 0; i < triplets_count; i++)
+		{
+			value_to_entries_inner_index_[value_insertion_index[triplet_to_value_index_map[i]]++] = entry_references[i];
+		}
+
+		hessian_entries_block_offsets_ = std::move(hessian_entries_block_offsets);
+		mapped_hessian_entries_blocks_ = std::move(mapped_hessian_entries_blocks);
+		hessian_entries_blocks_patchable_ = hessian_entries_blocks_patchable;
+		patched_hessian_entries_.clear();
+		stale_hessian_entries_count_ = 0;
+		hessian_entry_values_.resize(triplets_count);
+		mapped_hessian_entries_layout_version_ = hessian_entries_layout_version;
+		return true;
+	}
+
+	// Maps only the blocks of hessian entries that were added or whose layout changed since the entries were mapped, and moves the
+	// unchanged blocks to their new offsets. The entries of removed (or changed) blocks are left in the value-to-entries map and skipped
+	// when gathered, so a constraint edit costs the entries of the edited objective rather than the entries of the whole tree.
+	// Returns false (and leaves the current mapping as is) if an entry has no slot, or if so much of the map went stale that it should
+	// be rebuilt.
+	bool PatchHessianEntries()
+	{
+		if (!hessian_entries_blocks_patchable_)
+		{
+			return false;
+		}
+
+		const std::size_t hessian_entries_layout_version = GetHessianEntriesLayoutVersion();
+		std::vector<HessianEntriesBlock> hessian_entries_blocks;
+		AddHessianEntriesBlocks(hessian_entries_blocks);
+
+		std::vector<int64_t> hessian_entries_block_offsets(hessian_entries_block_offsets_.size(), -1);
+		std::unordered_map<const ObjectiveFunctionBase*, MappedHessianEntriesBlock> mapped_hessian_entries_blocks;
+		mapped_hessian_entries_blocks.reserve(hessian_entries_blocks.size());
+		std::vector<PatchedHessianEntry> patched_hessian_entries;
+		std::vector<Eigen::Triplet<double>> triplets;
+		int64_t entries_offset = 0;
+		for (const auto& hessian_entries_block : hessian_entries_blocks)
+		{
+			const auto mapped_hessian_entries_block_it = mapped_hessian_entries_blocks_.find(hessian_entries_block.objective_function);
+			const bool unchanged =
+				mapped_hessian_entries_block_it != mapped_hessian_entries_blocks_.end() &&
+				mapped_hessian_entries_block_it->second.entries_count == hessian_entries_block.entries_count &&
+				mapped_hessian_entries_block_it->second.entries_layout_version == hessian_entries_block.entries_layout_version;
+
+			MappedHessianEntriesBlock mapped_hessian_entries_block;
+			if (unchanged)
+			{
+				mapped_hessian_entries_block = mapped_hessian_entries_block_it->second;
+				hessian_entries_block_offsets[mapped_hessian_entries_block.block_index] = entries_offset;
+			}
+			else
+			{
+				triplets.clear();
+				hessian_entries_block.objective_function->AddTriplets(triplets);
+				if (triplets.size() != hessian_entries_block.entries_count)
+				{
+					return false;
+				}
+
+				mapped_hessian_entries_block = { static_cast<int64_t>(hessian_entries_block_offsets.size()), hessian_entries_block.entries_count, hessian_entries_block.entries_layout_version };
+				hessian_entries_block_offsets.push_back(entries_offset);
+				const int64_t entries_count = triplets.size();
+				for (int64_t i = 0; i < entries_count; i++)
+				{
+					const int64_t value_index = FindHessianValueIndex(triplets[i]);
+					if (value_index < 0)
+					{
+						return false;
+					}
+
+					patched_hessian_entries.push_back({ value_index, { mapped_hessian_entries_block.block_index, i } });
+				}
+			}
+
+			if (!mapped_hessian_entries_blocks.emplace(hessian_entries_block.objective_function, mapped_hessian_entries_block).second)
+			{
+				return false;
+			}
+
+			entries_offset += hessian_entries_block.entries_count;
+		}
+
+		// Entries of blocks that were not moved are stale. Once the stale and patched entries amount to a quarter of the entries,
+		// the map is rebuilt, so gathering the hessian does not slow down as constraints are edited.
+		int64_t stale_hessian_entries_count = stale_hessian_entries_count_;
+		for (const auto& mapped_hessian_entries_block : mapped_hessian_entries_blocks_)
+		{
+			if (hessian_entries_block_offsets[mapped_hessian_entries_block.second.block_index] < 0)
+			{
+				stale_hessian_entries_count += std::max<int64_t>(mapped_hessian_entries_block.second.entries_count, 1);
+			}
+		}
+
+		if (4 * (stale_hessian_entries_count + static_cast<int64_t>(patched_hessian_entries_.size() + patched_hessian_entries.size())) > entries_offset)
+		{
+			return false;
+		}
+
+		hessian_entries_block_offsets_ = std::move(hessian_entries_block_offsets);
+		mapped_hessian_entries_blocks_ = std::move(mapped_hessian_entries_blocks);
+		patched_hessian_entries_.insert(patched_hessian_entries_.end(), patched_hessian_entries.begin(), patched_hessian_entries.end());
+		stale_hessian_entries_count_ = stale_hessian_entries_count;
+		hessian_entry_values_.resize(entries_offset);
+		mapped_hessian_entries_layout_version_ = hessian_entries_layout_version;
+		return true;
+	}
+
+	// Gathers the current hessian entries into the persistent hessian structure
+	void AssembleHessian()
+	{
+		AddHessianEntries(hessian_entry_values_.data());
+
+		double* values = H_.valuePtr();
+		const int64_t values_count = H_.nonZeros();
+		tbb::parallel_for(tbb::blocked_range<int64_t>(0, values_count), [&](const tbb::blocked_range<int64_t>& range)
+		{
+			for (int64_t i = range.begin(); i < range.end(); i++)
+			{
+				double value = 0;
+				for (int64_t j = value_to_entries_outer_index_[i]; j < value_to_entries_outer_index_[i + 1]; j++)
+				{
+					const int64_t entry_index = GetHessianEntryIndex(value_to_entries_inner_index_[j]);
+					if (entry_index >= 0)
+					{
+						value += hessian_entry_values_[entry_index];
+					}
+				}
+				values[i] = value;
+			}
+		});
+
+		for (const auto& patched_hessian_entry : patched_hessian_entries_)
+		{
+			const int64_t entry_index = GetHessianEntryIndex(patched_hessian_entry.entry_reference);
+			if (entry_index >= 0)
+			{
+				values[patched_hessian_entry.value_index] += hessian_entry_values_[entry_index];
+			}
+		}
+	}
+
+	// Returns the index of a hessian entry in the entry values buffer, or -1 if its block is stale
+	int64_t GetHessianEntryIndex(const HessianEntryReference& entry_reference) const
+	{
+		const int64_t block_offset = hessian_entries_block_offsets_[entry_reference.block_index];
+		return block_offset < 0 ? -1 : block_offset + entry_reference.entry_index;
+	}
+
 	// Value, gradient and hessian calculation functions
 	virtual void CalculateValue(double& f) = 0;
 	virtual void CalculateValuePerVertex(VectorType_& f_per_vertex) = 0;
@@ -473,8 +1005,37 @@ private:
 	virtual void CalculateValuePerEdge(Eigen::VectorXd& domain_value_per_edge, Eigen::VectorXd& image_value_per_edge) = 0;
 	
 	virtual void CalculateGradient(VectorType_& g) = 0;
+
+	// Objectives whose gradient has a few fixed nonzero entries (regardless of VectorType_) may expose it as a local gradient:
+	// the (distinct) variables of these entries are listed once, and only their values are calculated on every update
+	virtual void InitializeLocalGradient(std::vector<RDS::SparseVariableIndex>& local_gradient_indices)
+	{
+		// Empty implementation (no local gradient)
+	}
+
+	virtual void CalculateLocalGradient(Eigen::VectorXd& local_g)
+	{
+		// Empty implementation
+	}
+
 	virtual void CalculateTriplets(std::vector<Eigen::Triplet<double>>& triplets) = 0;
 
+	// Only the entries of the local gradient can be nonzero, so the rest of the (lazily allocated) full gradient stays zero
+	void ExpandLocalGradient() const
+	{
+		if (g_.size() != mesh_data_provider_->GetVariablesCount())
+		{
+			g_.resize(mesh_data_provider_->GetVariablesCount());
+			g_.setZero();
+		}
+
+		const int64_t local_gradient_size = local_gradient_indices_.size();
+		for (int64_t i = 0; i < local_gradient_size; i++)
+		{
+			g_.coeffRef(local_gradient_indices_[i]) = local_g_.coeff(i);
+		}
+	}
+
 	// Epsilon calculation for finite differences
 	static double CalculateEpsilon(const Eigen::VectorXd& x)
 	{
@@ -493,22 +1054,55 @@ private:
 	// Value
 	double f_;
 
-	// Value per vertex
+	// Value per vertex (allocated on first read)
 	VectorType_ f_per_vertex_;
+	bool value_per_vertex_stale_;
 
-	// Value per edge
+	// Value per edge (allocated only by objectives that calculate it)
 	// TODO: Use generic VectorType_
 	Eigen::VectorXd image_value_per_edge_;
 	Eigen::VectorXd domain_value_per_edge_;
+	bool value_per_edge_stale_;
+
+	// Published values per vertex and per edge (objectives that do not calculate values per edge publish empty ones, and report zeros)
+	std::mutex published_diagnostics_mutex_;
+	VectorType_ published_f_per_vertex_;
+	Eigen::VectorXd published_image_value_per_edge_;
+	Eigen::VectorXd published_domain_value_per_edge_;
+	std::atomic<bool> value_per_vertex_subscribed_;
+	std::atomic<bool> value_per_edge_subscribed_;
+	std::atomic<bool> diagnostics_publication_pending_;
 
-	// Gradient
-	VectorType_ g_;
+	// Gradient (of objectives with a local gradient, allocated and filled only when read)
+	mutable VectorType_ g_;
+
+	// Local gradient
+	std::vector<RDS::SparseVariableIndex> local_gradient_indices_;
+	Eigen::VectorXd local_g_;
 
 	// Triplets
 	std::vector<Eigen::Triplet<double>> triplets_;
 
 	// Hessian
 	Eigen::SparseMatrix<double, StorageOrder_> H_;
+
+	// Persistent hessian pattern
+	std::vector<double> hessian_entry_values_;
+	std::vector<int64_t> value_to_entries_outer_index_;
+	std::vector<HessianEntryReference> value_to_entries_inner_index_;
+	bool persistent_hessian_pattern_enabled_;
+	bool hessian_pattern_initialized_;
+	std::size_t hessian_pattern_version_;
+
+	// Blocks of hessian entries (offset of each block in the entry values buffer, or -1 once it went stale)
+	std::vector<int64_t> hessian_entries_block_offsets_;
+	std::unordered_map<const ObjectiveFunctionBase*, MappedHessianEntriesBlock> mapped_hessian_entries_blocks_;
+	std::vector<PatchedHessianEntry> patched_hessian_entries_;
+	int64_t stale_hessian_entries_count_;
+	bool hessian_entries_blocks_patchable_;
+
+	// Version of the hessian entries layout the hessian entries were mapped for
+	std::size_t mapped_hessian_entries_layout_version_;
 	
 	// Weight
 	double w_;
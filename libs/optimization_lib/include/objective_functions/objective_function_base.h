@@ -4,9 +4,12 @@
 
 // STL includes
 #include <any>
+#include <atomic>
+#include <vector>
 
 // Eigen Includes
 #include <Eigen/Core>
+#include <Eigen/Sparse>
 
 // Optimization lib includes
 #include "../data_providers/mesh_data_provider.h"
@@ -49,6 +52,14 @@ public:
 		Count_
 	};
 
+	// A contiguous range of hessian entries, emitted by a single objective function (see AddHessianEntriesBlocks())
+	struct HessianEntriesBlock
+	{
+		const ObjectiveFunctionBase* objective_function;
+		std::size_t entries_count;
+		std::size_t entries_layout_version;
+	};
+
 	/**
 	 * Constructors and destructor
 	 */
@@ -64,6 +75,51 @@ public:
 	 * Setters
 	 */
 	virtual bool SetProperty(const int32_t property_id, const std::any property_context, const std::any property_value) = 0;
+
+	/**
+	 * Public methods
+	 */
+	virtual void AddTriplets(std::vector<Eigen::Triplet<double>>& triplets, const double w = 1) const = 0;
+
+	// Appends the blocks that make up the hessian entries of this objective function, in the order the entries are emitted by
+	// AddTriplets(), so roots can remap the entries of a single block when only that block changes
+	virtual void AddHessianEntriesBlocks(std::vector<HessianEntriesBlock>& hessian_entries_blocks) const = 0;
+
+	// Changes whenever the layout of the hessian entries of this objective function changes. Objective functions that forward the
+	// entries of others report the latest version among them.
+	virtual std::size_t GetHessianEntriesLayoutVersion() const;
+
+	// Changes whenever the definition of this objective function changes (e.g., its weight, its properties or its children), so
+	// state accumulated from previous evaluations (such as quasi-newton curvature pairs) can be discarded. Objective functions that
+	// aggregate others report the latest version among them.
+	virtual std::size_t GetDefinitionVersion() const;
+
+protected:
+	/**
+	 * Protected methods
+	 */
+
+	// Marks the hessian entries layout of this objective function as stale (e.g., when children are added, removed or reordered),
+	// so the roots that depend on it remap their hessian entries even if the total count did not change
+	void InvalidateHessianEntriesLayout();
+
+	// Marks the definition of this objective function as changed (see GetDefinitionVersion())
+	void InvalidateDefinition();
+
+private:
+	/**
+	 * Private fields
+	 */
+	std::atomic<std::size_t> hessian_entries_layout_version_;
+
+	// Versions are drawn from a single increasing sequence, so the latest version among the objective functions of a root increases
+	// whenever any of them is invalidated (even if another one is removed). Every objective function draws its initial version as well,
+	// so an objective function that is constructed where a removed one used to live is never mistaken for it.
+	static std::atomic<std::size_t> hessian_entries_layout_versions_sequence_;
+
+	// Definition versions are drawn from a single increasing sequence as well
+	std::atomic<std::size_t> definition_version_;
+	static std::atomic<std::size_t> definition_versions_sequence_;
 };
 
 // http://blog.bitwigglers.org/using-enum-classes-as-type-safe-bitmasks/
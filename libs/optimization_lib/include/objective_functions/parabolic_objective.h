@@ -28,7 +28,6 @@ public:
 	ParabolicObjective(const std::shared_ptr<MeshDataProvider>& mesh_data_provider, const std::shared_ptr<EmptyDataProvider>& empty_data_provider, const std::string& name, const std::shared_ptr<SparseObjectiveFunction<StorageOrder_>>& inner_objective, const double c0, const double c1, const double c2, const bool enforce_psd = true) :
 		CompositeObjective(mesh_data_provider, empty_data_provider, name, enforce_psd, inner_objective)
 	{
-		polynomial_coeffs_.resize(3);
 		SetC0(c0);
 		SetC1(c1);
 		SetC2(c2);
@@ -88,25 +87,19 @@ private:
 	 */
 	void CalculateDerivativesOuter(const double x, double& outer_value, double& outer_first_derivative, double& outer_second_derivative) override
 	{
-		const double f = x;
-		const double f2 = f * f;
-
-		Eigen::VectorXd values(3);
-
-		values << 1, f, f2;
-		outer_value = values.dot(polynomial_coeffs_);
-
-		values << 0, 1, 2 * f;
-		outer_first_derivative = values.dot(polynomial_coeffs_);
-
-		values << 0, 0, 2;
-		outer_second_derivative = values.dot(polynomial_coeffs_);
+		// Horner evaluation of c0 + c1 * x + c2 * x^2 and its derivatives
+		const double c0 = polynomial_coeffs_.coeff(0);
+		const double c1 = polynomial_coeffs_.coeff(1);
+		const double c2 = polynomial_coeffs_.coeff(2);
+		outer_value = (c2 * x + c1) * x + c0;
+		outer_first_derivative = 2 * c2 * x + c1;
+		outer_second_derivative = 2 * c2;
 	}
 
 	/**
 	 * Private fields
 	 */
-	Eigen::VectorXd polynomial_coeffs_;
+	Eigen::Vector3d polynomial_coeffs_;
 };
 
 #endif
\ No newline at end of file
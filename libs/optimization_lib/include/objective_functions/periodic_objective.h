@@ -51,30 +51,7 @@ public:
 		p_ = period;
 		p2_ = p_ * p_;
 		p3_ = p2_ * p_;
-		p4_ = p3_ * p_;
-		p5_ = p4_ * p_;
-
-		hp_ = period / 2;
-		hp2_ = hp_ * hp_;
-		hp3_ = hp2_ * hp_;
-		hp4_ = hp3_ * hp_;
-		hp5_ = hp4_ * hp_;
-
-		Eigen::VectorXd b(6);
-		b << 0, 0, 1, 0, 0, 0;
-
-		Eigen::MatrixXd A(6,6);
-		A <<		0,		   0,		   0,			0 ,		  0,	 1,
-					0,		   0,		   0,			0 ,		  1,	 0,
-				 hp5_,		hp4_,		hp3_,		  hp2_,		hp_,	 1,
-			 5 * hp4_,	4 * hp3_,	3 * hp2_,	  2 * hp_ ,		  1,	 0,
-				  p5_,		 p4_,		 p3_,		   p2_,		 p_,	 1,
-			 5 *  p4_,	4 *  p3_,	3 *  p2_,	  2 *  p_ ,		  1,	 0;
-
-		polynomial_coeffs_ = A.fullPivHouseholderQr().solve(b);
-		polynomial_coeffs_.coeffRef(0) = 0;
-		polynomial_coeffs_.coeffRef(4) = 0;
-		polynomial_coeffs_.coeffRef(5) = 0;
+		CalculatePolynomialCoeffs(period, polynomial_coeffs_);
 	}
 
 	bool SetProperty(const int32_t property_id, const std::any property_context, const std::any property_value) override
@@ -113,7 +90,7 @@ public:
 		return p3_;
 	}
 
-	const Eigen::VectorXd& GetPolynomialCoeffs() const
+	const Eigen::Matrix<double, 6, 1>& GetPolynomialCoeffs() const
 	{
 		return polynomial_coeffs_;
 	}
@@ -136,49 +113,80 @@ public:
 		return false;
 	}
 
-private:
 	/**
-	 * Private overrides
+	 * Public methods
 	 */
-	void CalculateDerivativesOuter(const double x, double& outer_value, double& outer_first_derivative, double& outer_second_derivative) override
+
+	// Coefficients (ordered from the highest degree down) of the quintic that is evaluated over each period. They are shared with
+	// objectives that evaluate periodic terms inline (e.g., BatchedSeamlessObjective).
+	static void CalculatePolynomialCoeffs(const double period, Eigen::Matrix<double, 6, 1>& polynomial_coeffs)
+	{
+		const double p = period;
+		const double p2 = p * p;
+		const double p3 = p2 * p;
+		const double p4 = p3 * p;
+		const double p5 = p4 * p;
+
+		const double hp = period / 2;
+		const double hp2 = hp * hp;
+		const double hp3 = hp2 * hp;
+		const double hp4 = hp3 * hp;
+		const double hp5 = hp4 * hp;
+
+		Eigen::Matrix<double, 6, 1> b;
+		b << 0, 0, 1, 0, 0, 0;
+
+		Eigen::Matrix<double, 6, 6> A;
+		A <<		0,		  0,		0,		   0,	  0,	1,
+					0,		  0,		0,		   0,	  1,	0,
+				  hp5,		hp4,	  hp3,		 hp2,	 hp,	1,
+			  5 * hp4,	4 * hp3,  3 * hp2,	  2 * hp,	  1,	0,
+				   p5,		 p4,	   p3,		  p2,	  p,	1,
+			   5 * p4,	 4 * p3,   3 * p2,	   2 * p,	  1,	0;
+
+		polynomial_coeffs = A.fullPivHouseholderQr().solve(b);
+		polynomial_coeffs.coeffRef(0) = 0;
+		polynomial_coeffs.coeffRef(4) = 0;
+		polynomial_coeffs.coeffRef(5) = 0;
+	}
+
+	// Value and derivatives of the periodic function at x, given the coefficients of CalculatePolynomialCoeffs()
+	static void CalculatePolynomialDerivatives(const double x, const double period, const Eigen::Matrix<double, 6, 1>& polynomial_coeffs, double& value, double& first_derivative, double& second_derivative)
 	{
-		double f = fmod(x, p_);
+		double f = fmod(x, period);
 		if (f < 0)
 		{
-			f += p_;
+			f += period;
 		}
-		
-		const double f2 = f * f;
-		const double f3 = f2 * f;
-		const double f4 = f3 * f;
-		const double f5 = f4 * f;
-		
-		Eigen::VectorXd values(6);
-
-		values << f5, f4, f3, f2, f, 1;
-		outer_value = values.dot(polynomial_coeffs_);
-
-		values << 5 * f4, 4 * f3, 3 * f2, 2 * f, 1, 0;
-		outer_first_derivative = values.dot(polynomial_coeffs_);
-
-		values << 20 * f3, 12 * f2, 6 * f, 2, 0, 0;
-		outer_second_derivative = values.dot(polynomial_coeffs_);
+
+		// Horner evaluation of the quintic and its derivatives (coefficients are ordered from the highest degree down)
+		const double c0 = polynomial_coeffs.coeff(0);
+		const double c1 = polynomial_coeffs.coeff(1);
+		const double c2 = polynomial_coeffs.coeff(2);
+		const double c3 = polynomial_coeffs.coeff(3);
+		const double c4 = polynomial_coeffs.coeff(4);
+		const double c5 = polynomial_coeffs.coeff(5);
+		value = ((((c0 * f + c1) * f + c2) * f + c3) * f + c4) * f + c5;
+		first_derivative = (((5 * c0 * f + 4 * c1) * f + 3 * c2) * f + 2 * c3) * f + c4;
+		second_derivative = ((20 * c0 * f + 12 * c1) * f + 6 * c2) * f + 2 * c3;
+	}
+
+private:
+	/**
+	 * Private overrides
+	 */
+	void CalculateDerivativesOuter(const double x, double& outer_value, double& outer_first_derivative, double& outer_second_derivative) override
+	{
+		CalculatePolynomialDerivatives(x, p_, polynomial_coeffs_, outer_value, outer_first_derivative, outer_second_derivative);
 	}
 	
 	/**
 	 * Private fields
 	 */
-	double hp_;
-	double hp2_;
-	double hp3_;
-	double hp4_;
-	double hp5_;
 	double p_;
 	double p2_;
 	double p3_;
-	double p4_;
-	double p5_;
-	Eigen::VectorXd polynomial_coeffs_;
+	Eigen::Matrix<double, 6, 1> polynomial_coeffs_;
 	
 };
 
@@ -41,6 +41,7 @@ public:
 	void MoveFacePosition(const Eigen::Vector2d& offset)
 	{
 		objective_barycenter_ += offset;
+		this->InvalidateDefinition();
 	}
 
 private:
@@ -69,14 +70,26 @@ private:
 
 	void CalculateGradient(Eigen::VectorXd& g) override
 	{
-		g.setZero();
+		// Empty implementation (the gradient is scattered from the local gradient, see CalculateLocalGradient())
+	}
+
+	void InitializeLocalGradient(std::vector<RDS::SparseVariableIndex>& local_gradient_indices) override
+	{
+		local_gradient_indices.resize(this->objective_variables_count_);
 		auto face_data_provider = this->GetFaceDataProvider();
 		auto face = face_data_provider->GetFace();
 		for (int64_t i = 0; i < this->objective_variables_count_; i++)
 		{
 			auto vertex_index = face[CalculateVertexEntry(i)];
-			auto variable_index = vertex_index + CalculateOffset(i);
-			g(variable_index) = gradient_coeff_ * barycenters_diff_(CalculateVariableType(i), 0);
+			local_gradient_indices[i] = vertex_index + CalculateOffset(i);
+		}
+	}
+
+	void CalculateLocalGradient(Eigen::VectorXd& local_g) override
+	{
+		for (int64_t i = 0; i < this->objective_variables_count_; i++)
+		{
+			local_g.coeffRef(i) = gradient_coeff_ * barycenters_diff_(CalculateVariableType(i), 0);
 		}
 	}
 
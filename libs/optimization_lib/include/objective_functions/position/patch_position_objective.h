@@ -11,6 +11,7 @@
 // Optimization lib includes
 #include "../../data_providers/face_data_provider.h"
 #include "../../data_providers/empty_data_provider.h"
+#include "../../data_providers/data_provider_registry.h"
 #include "../summation_objective.h"
 #include "face_position_objective.h"
 #include "../dense_objective_function.h"
@@ -24,7 +25,7 @@ public:
 	 * Constructors and destructor
 	 */
 	PatchPositionObjective(const std::shared_ptr<MeshDataProvider>& mesh_data_provider, const std::string& name) :
-		SummationObjective(mesh_data_provider, std::make_shared<EmptyDataProvider>(mesh_data_provider), name, false)
+		SummationObjective(mesh_data_provider, DataProviderRegistry::GetEmptyDataProvider(mesh_data_provider), name, false)
 	{
 
 	}
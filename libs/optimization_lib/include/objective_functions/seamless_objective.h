@@ -8,9 +8,7 @@
 
 // STL includes
 #include <vector>
-
-// TBB includes
-#include <tbb/concurrent_vector.h>
+#include <mutex>
 
 // Eigen includes
 #include <Eigen/Core>
@@ -18,6 +16,8 @@
 // Optimization lib includes
 #include "../data_providers/empty_data_provider.h"
 #include "../data_providers/edge_pair_data_provider.h"
+#include "../core/object_arena.h"
+#include "../data_providers/data_provider_registry.h"
 #include "./summation_objective.h"
 #include "./edge_pair/edge_pair_angle_objective.h"
 #include "./edge_pair/edge_pair_length_objective.h"
@@ -44,7 +44,10 @@ public:
 		LengthWeight,
 		TranslationWeight,
 		
-		Interval
+		Interval,
+
+		EdgeAngleWeights,
+		EdgeLengthWeights
 	};
 	
 	/**
@@ -99,35 +102,66 @@ public:
 		//zeta_ = zeta;
 	}
 
+	// The edge angle weight scales the periodic angle term of its edge pair (on top of the angle weight). It is kept on the inner angle objective,
+	// whose own weight is not read by the periodic objective.
 	void SetEdgeAngleWeight(const RDS::EdgeIndex edge_index, const double weight)
 	{
-		for (auto& periodic_edge_pair_angle_objective : periodic_edge_pair_angle_objectives)
+		const int64_t edge_pair_index = GetEdgePairIndex(edge_index);
+		if (edge_pair_index >= 0)
 		{
-			auto edge_pair_angle_objective = std::dynamic_pointer_cast<EdgePairAngleObjective<StorageOrder_>>(periodic_edge_pair_angle_objective->GetInnerObjective());
-			if (edge_pair_angle_objective->GetEdgePairDataProvider().GetDomainEdgeIndex() == edge_index)
-			{
-				edge_pair_angle_objective->SetWeight(weight);
-			}
+			edge_pair_angle_objectives[edge_pair_index]->SetWeight(weight);
+			periodic_edge_pair_angle_objectives[edge_pair_index]->SetWeight(angle_weight_ * weight);
 		}
 	}
 
 	void SetEdgeLengthWeight(const RDS::EdgeIndex edge_index, const double weight)
 	{
-		for (auto& edge_pair_length_objective : edge_pair_length_objectives)
+		const int64_t edge_pair_index = GetEdgePairIndex(edge_index);
+		if (edge_pair_index >= 0)
+		{
+			edge_pair_length_objectives[edge_pair_index]->SetWeight(weight);
+		}
+	}
+
+	// Sets the angle weights of all edge pairs at once, from a vector indexed by domain edge index
+	void SetEdgeAngleWeights(const Eigen::VectorXd& edge_angle_weights)
+	{
+		if (!HasWeightPerDomainEdge(edge_angle_weights))
+		{
+			throw std::exception("Expected an angle weight per domain edge");
+		}
+
+		const int64_t edge_pairs_count = edge_pair_angle_objectives.size();
+		for (int64_t i = 0; i < edge_pairs_count; i++)
 		{
-			if (edge_pair_length_objective->GetEdgePairDataProvider().GetDomainEdgeIndex() == edge_index)
-			{
-				edge_pair_length_objective->SetWeight(weight);
-			}
+			const double weight = edge_angle_weights.coeff(edge_pair_angle_objectives[i]->GetEdgePairDataProvider().GetDomainEdgeIndex());
+			edge_pair_angle_objectives[i]->SetWeight(weight);
+			periodic_edge_pair_angle_objectives[i]->SetWeight(angle_weight_ * weight);
+		}
+	}
+
+	// Sets the length weights of all edge pairs at once, from a vector indexed by domain edge index
+	void SetEdgeLengthWeights(const Eigen::VectorXd& edge_length_weights)
+	{
+		if (!HasWeightPerDomainEdge(edge_length_weights))
+		{
+			throw std::exception("Expected a length weight per domain edge");
+		}
+
+		const int64_t edge_pairs_count = edge_pair_length_objectives.size();
+		for (int64_t i = 0; i < edge_pairs_count; i++)
+		{
+			edge_pair_length_objectives[i]->SetWeight(edge_length_weights.coeff(edge_pair_length_objectives[i]->GetEdgePairDataProvider().GetDomainEdgeIndex()));
 		}
 	}
 	
 	void SetAngleWeight(const double weight)
 	{
 		angle_weight_ = weight;
-		for (auto& periodic_edge_pair_angle_objective : periodic_edge_pair_angle_objectives)
+		const int64_t edge_pairs_count = periodic_edge_pair_angle_objectives.size();
+		for (int64_t i = 0; i < edge_pairs_count; i++)
 		{
-			periodic_edge_pair_angle_objective->SetWeight(weight);
+			periodic_edge_pair_angle_objectives[i]->SetWeight(weight * edge_pair_angle_objectives[i]->GetWeight());
 		}
 	}
 
@@ -185,6 +219,12 @@ public:
 		case Properties::Interval:
 			SetInterval(std::any_cast<const double>(property_value));
 			return true;
+		case Properties::EdgeAngleWeights:
+			SetEdgeAngleWeights(std::any_cast<const Eigen::VectorXd&>(property_value));
+			return true;
+		case Properties::EdgeLengthWeights:
+			SetEdgeLengthWeights(std::any_cast<const Eigen::VectorXd&>(property_value));
+			return true;
 		}
 
 		return false;
@@ -198,6 +238,7 @@ public:
 		return zeta_;
 	}
 
+	// The angle and length values per edge are read from their published copies (see ObjectiveFunction::PublishDiagnostics())
 	const Eigen::VectorXd& SeamlessObjective::GetAngleValuePerEdge(const ObjectiveFunctionBase::PropertyModifiers property_modifiers) const
 	{
 		switch (property_modifiers)
@@ -222,46 +263,41 @@ public:
 
 	const Eigen::VectorXd& SeamlessObjective::GetImageAngleValuePerEdge() const
 	{
-		return image_angle_value_per_edge_;
+		return published_image_angle_value_per_edge_;
 	}
 
 	const Eigen::VectorXd& SeamlessObjective::GetImageLengthValuePerEdge() const
 	{
-		return image_length_value_per_edge_;
+		return published_image_length_value_per_edge_;
 	}
 
 	const Eigen::VectorXd& SeamlessObjective::GetDomainAngleValuePerEdge() const
 	{
-		return domain_angle_value_per_edge_;
+		return published_domain_angle_value_per_edge_;
 	}
 
 	const Eigen::VectorXd& SeamlessObjective::GetDomainLengthValuePerEdge() const
 	{
-		return domain_length_value_per_edge_;
+		return published_domain_length_value_per_edge_;
 	}
 
-	double GetEdgeAngleWeight(const RDS::EdgeIndex edge_index)
+	double GetEdgeAngleWeight(const RDS::EdgeIndex edge_index) const
 	{
-		for (auto& periodic_edge_pair_angle_objective : periodic_edge_pair_angle_objectives)
+		const int64_t edge_pair_index = GetEdgePairIndex(edge_index);
+		if (edge_pair_index >= 0)
 		{
-			auto edge_pair_angle_objective = std::dynamic_pointer_cast<EdgePairAngleObjective<StorageOrder_>>(periodic_edge_pair_angle_objective->GetInnerObjective());
-			if (edge_pair_angle_objective->GetEdgePairDataProvider().GetDomainEdgeIndex() == edge_index)
-			{
-				return edge_pair_angle_objective->GetWeight();
-			}
+			return edge_pair_angle_objectives[edge_pair_index]->GetWeight();
 		}
 
 		return 0;
 	}
 
-	double GetEdgeLengthWeight(const RDS::EdgeIndex edge_index)
+	double GetEdgeLengthWeight(const RDS::EdgeIndex edge_index) const
 	{
-		for (auto& edge_pair_length_objective : edge_pair_length_objectives)
+		const int64_t edge_pair_index = GetEdgePairIndex(edge_index);
+		if (edge_pair_index >= 0)
 		{
-			if (edge_pair_length_objective->GetEdgePairDataProvider().GetDomainEdgeIndex() == edge_index)
-			{
-				return edge_pair_length_objective->GetWeight();
-			}
+			return edge_pair_length_objectives[edge_pair_index]->GetWeight();
 		}
 
 		return 0;
@@ -297,11 +333,17 @@ public:
 			property_value = GetZeta();
 			return true;
 		case Properties::AngleValuePerEdge:
+		{
+			const auto lock = this->LockPublishedValuePerEdge();
 			property_value = GetAngleValuePerEdge(property_modifiers);
 			return true;
+		}
 		case Properties::LengthValuePerEdge:
+		{
+			const auto lock = this->LockPublishedValuePerEdge();
 			property_value = GetLengthValuePerEdge(property_modifiers);
 			return true;
+		}
 		case Properties::EdgeAngleWeight:
 			property_value = GetEdgeAngleWeight(static_cast<RDS::EdgeIndex>(std::any_cast<double>(property_context)));
 			return true;
@@ -327,14 +369,15 @@ public:
 	 */	
 	void AddEdgePairObjectives(const std::shared_ptr<EdgePairDataProvider>& edge_pair_data_provider)
 	{	
-		auto edge_pair_angle_objective = std::make_shared<EdgePairAngleObjective<StorageOrder_>>(this->GetMeshDataProvider(), edge_pair_data_provider, false);
-		auto edge_pair_length_objective = std::make_shared<EdgePairLengthObjective<StorageOrder_>>(this->GetMeshDataProvider(), edge_pair_data_provider, false);
-		auto edge_pair_integer_translation_objective = std::make_shared<EdgePairIntegerTranslationObjective<StorageOrder_>>(this->GetMeshDataProvider(), edge_pair_data_provider, this->GetEnforceChildrenPsd());
+		ObjectArena& object_arena = this->GetMeshDataProvider()->GetObjectArena();
+		auto edge_pair_angle_objective = object_arena.MakeShared<EdgePairAngleObjective<StorageOrder_>>(this->GetMeshDataProvider(), edge_pair_data_provider, false);
+		auto edge_pair_length_objective = object_arena.MakeShared<EdgePairLengthObjective<StorageOrder_>>(this->GetMeshDataProvider(), edge_pair_data_provider, false);
+		auto edge_pair_integer_translation_objective = object_arena.MakeShared<EdgePairIntegerTranslationObjective<StorageOrder_>>(this->GetMeshDataProvider(), edge_pair_data_provider, this->GetEnforceChildrenPsd());
 		//auto edge_pair_translation_objective = std::make_shared<EdgePairTranslationObjective<StorageOrder_>>(this->GetMeshDataProvider(), edge_pair_data_provider, this->GetEnforceChildrenPsd());
 		
 		double period = M_PI / 2;
-		auto empty_data_provider = std::make_shared<EmptyDataProvider>(this->GetMeshDataProvider());
-		std::shared_ptr<PeriodicObjective<StorageOrder_>> periodic_edge_pair_angle_objective = std::make_shared<PeriodicObjective<StorageOrder_>>(this->GetMeshDataProvider(), empty_data_provider, edge_pair_angle_objective, period, this->GetEnforceChildrenPsd());
+		auto empty_data_provider = DataProviderRegistry::GetEmptyDataProvider(this->GetMeshDataProvider());
+		std::shared_ptr<PeriodicObjective<StorageOrder_>> periodic_edge_pair_angle_objective = object_arena.MakeShared<PeriodicObjective<StorageOrder_>>(this->GetMeshDataProvider(), empty_data_provider, edge_pair_angle_objective, period, this->GetEnforceChildrenPsd());
 
 		periodic_edge_pair_angle_objective->SetWeight(angle_weight_);
 		edge_pair_length_objective->SetWeight(length_weight_);
@@ -345,6 +388,16 @@ public:
 		this->AddObjectiveFunction(edge_pair_length_objective);
 		this->AddObjectiveFunction(edge_pair_integer_translation_objective);
 		//this->AddObjectiveFunction(edge_pair_translation_objective);
+
+		// Edge pairs are added from within parallel loops. The objectives of an edge pair are stored at the same index in all
+		// edge pair objective arrays, and that index is registered under the domain edge of the edge pair.
+		std::lock_guard<std::mutex> lock(this->m_);
+		const RDS::EdgeIndex domain_edge_index = edge_pair_data_provider->GetDomainEdgeIndex();
+		if (static_cast<std::size_t>(domain_edge_index) >= domain_edge_to_edge_pair_index_.size())
+		{
+			domain_edge_to_edge_pair_index_.resize(std::max(static_cast<std::size_t>(domain_edge_index) + 1, static_cast<std::size_t>(this->GetMeshDataProvider()->GetDomainEdgesCount())), -1);
+		}
+		domain_edge_to_edge_pair_index_[domain_edge_index] = periodic_edge_pair_angle_objectives.size();
 		
 		periodic_edge_pair_angle_objectives.push_back(periodic_edge_pair_angle_objective);
 		edge_pair_length_objectives.push_back(edge_pair_length_objective);
@@ -364,6 +417,19 @@ protected:
 		image_length_value_per_edge_.resize(this->mesh_data_provider_->GetImageEdgesCount());
 		domain_angle_value_per_edge_.resize(this->mesh_data_provider_->GetDomainEdgesCount());
 		domain_length_value_per_edge_.resize(this->mesh_data_provider_->GetDomainEdgesCount());
+		published_image_angle_value_per_edge_.setZero(this->mesh_data_provider_->GetImageEdgesCount());
+		published_image_length_value_per_edge_.setZero(this->mesh_data_provider_->GetImageEdgesCount());
+		published_domain_angle_value_per_edge_.setZero(this->mesh_data_provider_->GetDomainEdgesCount());
+		published_domain_length_value_per_edge_.setZero(this->mesh_data_provider_->GetDomainEdgesCount());
+	}
+
+	void PublishValuePerEdge() override
+	{
+		SummationObjective<ObjectiveFunction<StorageOrder_, Eigen::SparseVector<double>>, Eigen::VectorXd>::PublishValuePerEdge();
+		published_image_angle_value_per_edge_ = image_angle_value_per_edge_;
+		published_image_length_value_per_edge_ = image_length_value_per_edge_;
+		published_domain_angle_value_per_edge_ = domain_angle_value_per_edge_;
+		published_domain_length_value_per_edge_ = domain_length_value_per_edge_;
 	}
 	
 private:
@@ -382,13 +448,33 @@ private:
 	/**
 	 * Private methods
 	 */
+
+	// Index of the edge pair of a domain edge in the edge pair objective arrays, or -1 if the domain edge is not a seam edge
+	int64_t GetEdgePairIndex(const RDS::EdgeIndex domain_edge_index) const
+	{
+		if (domain_edge_index < 0 || static_cast<std::size_t>(domain_edge_index) >= domain_edge_to_edge_pair_index_.size())
+		{
+			return -1;
+		}
+
+		return domain_edge_to_edge_pair_index_[domain_edge_index];
+	}
+
+	// Bulk per-edge weights are indexed by domain edge index, so they must hold a weight for every domain edge
+	bool HasWeightPerDomainEdge(const Eigen::VectorXd& edge_weights) const
+	{
+		return edge_weights.rows() == this->GetMeshDataProvider()->GetDomainEdgesCount();
+	}
+
 	void CalculateAngleValuePerEdge(Eigen::VectorXd& domain_angle_value_per_edge, Eigen::VectorXd& image_angle_value_per_edge)
 	{
 		domain_angle_value_per_edge.setZero();
 		image_angle_value_per_edge.setZero();
-		for(const auto& periodic_edge_pair_angle_objective : periodic_edge_pair_angle_objectives)
+		const int64_t edge_pairs_count = periodic_edge_pair_angle_objectives.size();
+		for (int64_t i = 0; i < edge_pairs_count; i++)
 		{
-			auto edge_pair_angle_objective = std::dynamic_pointer_cast<EdgePairAngleObjective<StorageOrder_>>(periodic_edge_pair_angle_objective->GetInnerObjective());
+			const auto& periodic_edge_pair_angle_objective = periodic_edge_pair_angle_objectives[i];
+			const auto& edge_pair_angle_objective = edge_pair_angle_objectives[i];
 			const RDS::EdgeIndex domain_edge_index = edge_pair_angle_objective->GetEdgePairDataProvider().GetDomainEdgeIndex();
 			const RDS::EdgeIndex image_edge_1_index = edge_pair_angle_objective->GetEdgePairDataProvider().GetImageEdge1Index();
 			const RDS::EdgeIndex image_edge_2_index = edge_pair_angle_objective->GetEdgePairDataProvider().GetImageEdge2Index();
@@ -427,16 +513,25 @@ private:
 	double length_weight_;
 	double translation_weight_;
 	
-	tbb::concurrent_vector<std::shared_ptr<EdgePairLengthObjective<StorageOrder_>>> edge_pair_length_objectives;
-	tbb::concurrent_vector<std::shared_ptr<EdgePairAngleObjective<StorageOrder_>>> edge_pair_angle_objectives;
-	tbb::concurrent_vector<std::shared_ptr<PeriodicObjective<StorageOrder_>>> periodic_edge_pair_angle_objectives;
-	tbb::concurrent_vector<std::shared_ptr<EdgePairIntegerTranslationObjective<StorageOrder_>>> edge_pair_integer_translation_objectives;
-	tbb::concurrent_vector<std::shared_ptr<EdgePairTranslationObjective<StorageOrder_>>> edge_pair_translation_objectives;
+	std::vector<std::shared_ptr<EdgePairLengthObjective<StorageOrder_>>> edge_pair_length_objectives;
+	std::vector<std::shared_ptr<EdgePairAngleObjective<StorageOrder_>>> edge_pair_angle_objectives;
+	std::vector<std::shared_ptr<PeriodicObjective<StorageOrder_>>> periodic_edge_pair_angle_objectives;
+	std::vector<std::shared_ptr<EdgePairIntegerTranslationObjective<StorageOrder_>>> edge_pair_integer_translation_objectives;
+	std::vector<std::shared_ptr<EdgePairTranslationObjective<StorageOrder_>>> edge_pair_translation_objectives;
+
+	// Domain edge index to edge pair index lookup table (-1 for domain edges that are not seam edges)
+	std::vector<int64_t> domain_edge_to_edge_pair_index_;
 	
 	Eigen::VectorXd image_angle_value_per_edge_;
 	Eigen::VectorXd image_length_value_per_edge_;
 	Eigen::VectorXd domain_angle_value_per_edge_;
 	Eigen::VectorXd domain_length_value_per_edge_;
+
+	// Published value per edge
+	Eigen::VectorXd published_image_angle_value_per_edge_;
+	Eigen::VectorXd published_image_length_value_per_edge_;
+	Eigen::VectorXd published_domain_angle_value_per_edge_;
+	Eigen::VectorXd published_domain_length_value_per_edge_;
 };
 
 #endif
\ No newline at end of file
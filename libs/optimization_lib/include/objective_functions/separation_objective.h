@@ -5,6 +5,9 @@
 // STL includes
 #include <vector>
 
+// TBB includes
+#include <tbb/parallel_for.h>
+
 // Optimization lib includes
 #include "../data_providers/plain_data_provider.h"
 #include "./dense_objective_function.h"
@@ -42,6 +45,7 @@ public:
 	void SetDelta(const double delta)
 	{
 		delta_ = delta;
+		this->InvalidateDefinition();
 	}
 
 	bool SetProperty(const int32_t property_id, const std::any property_context, const std::any property_value) override
@@ -101,12 +105,11 @@ private:
 		
 		int rows = EsepP.rows();
 		
-		#pragma omp parallel for
-		for(int i = 0; i < rows; i++)
+		tbb::parallel_for(0, rows, [&](const int i)
 		{
 			EsepP_squared.coeffRef(i, 0) = EsepP.coeffRef(i, 0) * EsepP.coeffRef(i, 0);
 			EsepP_squared.coeffRef(i, 1) = EsepP.coeffRef(i, 1) * EsepP.coeffRef(i, 1);
-		}
+		});
 		
 		EsepP_squared_rowwise_sum = EsepP_squared.rowwise().sum();
 		EsepP_squared_rowwise_sum_plus_delta = EsepP_squared_rowwise_sum.array() + delta_;
@@ -121,17 +124,14 @@ private:
 
 	void CalculateValuePerVertex(Eigen::VectorXd& f_per_vertex) override
 	{
+		// Edge pairs share vertices, so their values are accumulated sequentially
 		f_per_vertex.setZero();
-		int64_t vertex1_index;
-		int64_t vertex2_index;
-		
-		#pragma omp parallel for
-		for (int i = 0; i < Esept.outerSize(); ++i)
+		for (int i = 0; i < Esept.outerSize(); i++)
 		{
 			// no inner loop because there are only 2 nnz values per col
 			Eigen::SparseMatrix<double>::InnerIterator it(Esept, i);
-			int64_t vertex1_index = it.row();
-			int64_t vertex2_index = (++it).row();
+			const int64_t vertex1_index = it.row();
+			const int64_t vertex2_index = (++it).row();
 
 			f_per_vertex.coeffRef(vertex1_index) += EsepP_squared_rowwise_sum[i];
 			f_per_vertex.coeffRef(vertex2_index) += EsepP_squared_rowwise_sum[i];
@@ -209,8 +209,7 @@ private:
 	void CalculateRawTriplets(std::vector<Eigen::Triplet<double>>& triplets) override
 	{
 		// no inner loop because there are only 2 nnz values per col
-		#pragma omp parallel for
-		for (int i = 0; i < Esept.outerSize(); ++i)
+		tbb::parallel_for(0, static_cast<int>(Esept.outerSize()), [&](const int i)
 		{
 			Eigen::Vector2d xi, xj;
 			Eigen::Matrix4d sh;
@@ -238,7 +237,7 @@ private:
 					const_cast<double&>(triplets[ind++].value()) = sh(b, a);
 				}
 			}
-		}
+		});
 	}
 	
 	/**
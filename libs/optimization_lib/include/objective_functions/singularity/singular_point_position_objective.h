@@ -13,10 +13,12 @@
 #include <Eigen/Core>
 
 // Optimization lib includes
+#include "../../core/object_arena.h"
 #include "../summation_objective.h"
 #include "../coordinate_objective.h"
 #include "../periodic_objective.h"
 #include "../../data_providers/face_fan_data_provider.h"
+#include "../../data_providers/data_provider_registry.h"
 
 template <Eigen::StorageOptions StorageOrder_>
 class SingularPointPositionObjective : public SummationObjective<PeriodicObjective<StorageOrder_>, Eigen::SparseVector<double>>
@@ -131,17 +133,18 @@ public:
 	{
 		const auto face_fan_data_provider = GetFaceFanDataProvider();
 		auto face_fan = face_fan_data_provider->GetFaceFan();
+		ObjectArena& object_arena = this->GetMeshDataProvider()->GetObjectArena();
 		for (auto& face_fan_slice : face_fan)
 		{
-			auto x_coordinate_data_provider = std::make_shared<CoordinateDataProvider>(this->mesh_data_provider_, face_fan_slice.first, RDS::CoordinateType::X);
-			auto y_coordinate_data_provider = std::make_shared<CoordinateDataProvider>(this->mesh_data_provider_, face_fan_slice.first, RDS::CoordinateType::Y);
+			auto x_coordinate_data_provider = DataProviderRegistry::GetCoordinateDataProvider(this->mesh_data_provider_, face_fan_slice.first, RDS::CoordinateType::X);
+			auto y_coordinate_data_provider = DataProviderRegistry::GetCoordinateDataProvider(this->mesh_data_provider_, face_fan_slice.first, RDS::CoordinateType::Y);
 
-			auto x_coordinate_objective = std::make_shared<CoordinateObjective<StorageOrder_>>(this->GetMeshDataProvider(), x_coordinate_data_provider);
-			auto y_coordinate_objective = std::make_shared<CoordinateObjective<StorageOrder_>>(this->GetMeshDataProvider(), y_coordinate_data_provider);
+			auto x_coordinate_objective = object_arena.MakeShared<CoordinateObjective<StorageOrder_>>(this->GetMeshDataProvider(), x_coordinate_data_provider);
+			auto y_coordinate_objective = object_arena.MakeShared<CoordinateObjective<StorageOrder_>>(this->GetMeshDataProvider(), y_coordinate_data_provider);
 
-			auto empty_data_provider = std::make_shared<EmptyDataProvider>(this->GetMeshDataProvider());
-			std::shared_ptr<PeriodicObjective<StorageOrder_>> periodic_x_coordinate_objective = std::make_shared<PeriodicObjective<StorageOrder_>>(this->GetMeshDataProvider(), empty_data_provider, x_coordinate_objective, interval_, this->GetEnforceChildrenPsd());
-			std::shared_ptr<PeriodicObjective<StorageOrder_>> periodic_y_coordinate_objective = std::make_shared<PeriodicObjective<StorageOrder_>>(this->GetMeshDataProvider(), empty_data_provider, y_coordinate_objective, interval_, this->GetEnforceChildrenPsd());
+			auto empty_data_provider = DataProviderRegistry::GetEmptyDataProvider(this->GetMeshDataProvider());
+			std::shared_ptr<PeriodicObjective<StorageOrder_>> periodic_x_coordinate_objective = object_arena.MakeShared<PeriodicObjective<StorageOrder_>>(this->GetMeshDataProvider(), empty_data_provider, x_coordinate_objective, interval_, this->GetEnforceChildrenPsd());
+			std::shared_ptr<PeriodicObjective<StorageOrder_>> periodic_y_coordinate_objective = object_arena.MakeShared<PeriodicObjective<StorageOrder_>>(this->GetMeshDataProvider(), empty_data_provider, y_coordinate_objective, interval_, this->GetEnforceChildrenPsd());
 			
 			this->AddObjectiveFunction(periodic_x_coordinate_objective);
 			this->AddObjectiveFunction(periodic_y_coordinate_objective);
@@ -10,6 +10,7 @@
 
 // Optimization lib includes
 #include "../../data_providers/empty_data_provider.h"
+#include "../../core/object_arena.h"
 #include "../summation_objective.h"
 #include "./singular_point_position_objective.h"
 
@@ -144,7 +145,8 @@ public:
 	 */
 	void AddSingularPointObjective(const std::shared_ptr<FaceFanDataProvider>& face_fan_data_provider)
 	{
-		this->AddObjectiveFunction(std::make_shared<SingularPointPositionObjective<StorageOrder_>>(this->GetMeshDataProvider(), face_fan_data_provider, interval_, this->GetEnforceChildrenPsd()));
+		ObjectArena& object_arena = this->GetMeshDataProvider()->GetObjectArena();
+		this->AddObjectiveFunction(object_arena.MakeShared<SingularPointPositionObjective<StorageOrder_>>(this->GetMeshDataProvider(), face_fan_data_provider, interval_, this->GetEnforceChildrenPsd()));
 	}
 
 protected:
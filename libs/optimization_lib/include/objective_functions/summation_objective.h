@@ -4,10 +4,15 @@
 
 // STL includes
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
 #include <vector>
+#include <unordered_map>
+#include <algorithm>
 
 // TBB includes
-#include <tbb/concurrent_vector.h>
+#include <tbb/parallel_for.h>
 
 // Optimization lib includes
 #include "./objective_function.h"
@@ -80,42 +85,39 @@ public:
 	/**
 	 * Public Methods
 	 */
+	// Adding or removing children invalidates the dependency graphs (see UpdatableObject::OnDependencyAdded() for patching them instead).
+	// Children are kept in a dense array (for the parallel evaluation loops) and indexed by their pointers and names, so adding,
+	// removing and looking up a child take constant time regardless of the number of children. Removing a child moves the
+	// last child into its place, so the indices of the remaining children are not stable (the children pointers are).
+	// Edits take the children lock exclusively, and every traversal of the children takes it shared.
 	void AddObjectiveFunction(const std::shared_ptr<ObjectiveFunctionType_>& objective_function)
 	{
-		objective_functions_.push_back(objective_function);
-		this->dependencies_.push_back(objective_function);
+		std::unique_lock<std::shared_mutex> lock(objective_functions_mutex_);
+		InsertObjectiveFunction(objective_function);
+		UpdatableObject::InvalidateDependencyLayers();
+		ObjectiveFunctionBase::InvalidateHessianEntriesLayout();
 	}
 
 	void AddObjectiveFunctions(const std::vector<std::shared_ptr<ObjectiveFunctionType_>>& objective_functions)
 	{
+		std::unique_lock<std::shared_mutex> lock(objective_functions_mutex_);
 		for (auto& objective_function : objective_functions)
 		{
-			objective_functions_.push_back(objective_function);
-			this->dependencies_.push_back(objective_function);
+			InsertObjectiveFunction(objective_function);
 		}
+
+		UpdatableObject::InvalidateDependencyLayers();
+		ObjectiveFunctionBase::InvalidateHessianEntriesLayout();
 	}
 
 	void RemoveObjectiveFunction(const std::shared_ptr<ObjectiveFunctionType_>& objective_function)
 	{
-		tbb::concurrent_vector<std::shared_ptr<ObjectiveFunctionType_>> objective_functions;
-		for (const auto& current_objective_function : objective_functions_)
+		std::unique_lock<std::shared_mutex> lock(objective_functions_mutex_);
+		if (EraseObjectiveFunction(objective_function))
 		{
-			if(current_objective_function != objective_function)
-			{
-				objective_functions.push_back(current_objective_function);
-			}
-		}
-		objective_functions_ = objective_functions;
-
-		tbb::concurrent_vector<std::shared_ptr<UpdatableObject>> dependencies;
-		for (const auto& current_dependency : this->dependencies_)
-		{
-			if (current_dependency != objective_function)
-			{
-				dependencies.push_back(current_dependency);
-			}
+			UpdatableObject::InvalidateDependencyLayers();
+			ObjectiveFunctionBase::InvalidateHessianEntriesLayout();
 		}
-		this->dependencies_ = dependencies;
 	}
 
 	void RemoveObjectiveFunctions(const std::vector<std::shared_ptr<ObjectiveFunctionType_>>& objective_functions)
@@ -128,11 +130,19 @@ public:
 
 	std::size_t GetObjectiveFunctionsCount() const
 	{
+		std::shared_lock<std::shared_mutex> lock(objective_functions_mutex_);
 		return objective_functions_.size();
 	}
 
+	bool HasObjectiveFunction(const std::shared_ptr<ObjectiveFunctionType_>& objective_function) const
+	{
+		std::shared_lock<std::shared_mutex> lock(objective_functions_mutex_);
+		return objective_function_slots_.find(objective_function.get()) != objective_function_slots_.end();
+	}
+
 	std::shared_ptr<ObjectiveFunctionType_> GetObjectiveFunction(std::uint32_t index) const
 	{
+		std::shared_lock<std::shared_mutex> lock(objective_functions_mutex_);
 		if (index < objective_functions_.size())
 		{
 			return objective_functions_.at(index);
@@ -143,23 +153,160 @@ public:
 
 	std::shared_ptr<ObjectiveFunctionType_> GetObjectiveFunction(const std::string& name) const
 	{
-		for (auto& objective_function : objective_functions_)
+		std::shared_lock<std::shared_mutex> lock(objective_functions_mutex_);
+		const auto name_index_it = name_to_objective_functions_.find(name);
+		if (name_index_it != name_to_objective_functions_.end())
+		{
+			return name_index_it->second.front();
+		}
+
+		return nullptr;
+	}
+
+	/**
+	 * Public overrides
+	 */
+
+	// Children triplets are not concatenated into this objective; they are forwarded (recursively) with their accumulated weights
+	void AddTriplets(std::vector<Eigen::Triplet<double>>& triplets, const double w = 1) const override
+	{
+		std::shared_lock<std::shared_mutex> lock(objective_functions_mutex_);
+		for (const auto& objective_function : objective_functions_)
+		{
+			objective_function->AddTriplets(triplets, w * objective_function->GetWeight());
+		}
+	}
+
+	std::size_t GetHessianEntriesCount() const override
+	{
+		std::shared_lock<std::shared_mutex> lock(objective_functions_mutex_);
+		std::size_t hessian_entries_count = 0;
+		for (const auto& objective_function : objective_functions_)
+		{
+			hessian_entries_count += objective_function->GetHessianEntriesCount();
+		}
+
+		return hessian_entries_count;
+	}
+
+	// Children make up their own blocks, so adding or removing a child does not require remapping the entries of its siblings
+	void AddHessianEntriesBlocks(std::vector<ObjectiveFunctionBase::HessianEntriesBlock>& hessian_entries_blocks) const override
+	{
+		std::shared_lock<std::shared_mutex> lock(objective_functions_mutex_);
+		for (const auto& objective_function : objective_functions_)
+		{
+			objective_function->AddHessianEntriesBlocks(hessian_entries_blocks);
+		}
+	}
+
+	void AddHessianEntries(double* entry_values, const double w = 1) const override
+	{
+		std::shared_lock<std::shared_mutex> lock(objective_functions_mutex_);
+		const int64_t objective_functions_count = objective_functions_.size();
+		hessian_entries_offsets_.resize(objective_functions_count + 1);
+		hessian_entries_offsets_[0] = 0;
+		for (int64_t i = 0; i < objective_functions_count; i++)
+		{
+			hessian_entries_offsets_[i + 1] = hessian_entries_offsets_[i] + objective_functions_[i]->GetHessianEntriesCount();
+		}
+
+		tbb::parallel_for(static_cast<int64_t>(0), objective_functions_count, [&](const int64_t i)
+		{
+			const auto& objective_function = objective_functions_[i];
+			const double child_w = w * objective_function->GetWeight();
+			if (child_w == 0)
+			{
+				// Inactive children are not updated, so their (stale) entries are not read at all
+				std::fill(entry_values + hessian_entries_offsets_[i], entry_values + hessian_entries_offsets_[i + 1], 0);
+				return;
+			}
+
+			objective_function->AddHessianEntries(entry_values + hessian_entries_offsets_[i], child_w);
+		});
+	}
+
+	void AddHessianVectorProduct(const Eigen::VectorXd& v, Eigen::VectorXd& Hv, const double w = 1) const override
+	{
+		std::shared_lock<std::shared_mutex> lock(objective_functions_mutex_);
+		for (const auto& objective_function : objective_functions_)
+		{
+			if (objective_function->GetWeight() != 0)
+			{
+				objective_function->AddHessianVectorProduct(v, Hv, w * objective_function->GetWeight());
+			}
+		}
+	}
+
+	void AddHessianDiagonal(Eigen::VectorXd& diagonal, const double w = 1) const override
+	{
+		std::shared_lock<std::shared_mutex> lock(objective_functions_mutex_);
+		for (const auto& objective_function : objective_functions_)
 		{
-			if (!objective_function->GetName().compare(name))
+			if (objective_function->GetWeight() != 0)
 			{
-				return objective_function;
+				objective_function->AddHessianDiagonal(diagonal, w * objective_function->GetWeight());
 			}
 		}
+	}
 
-		return nullptr;
+	// The layout of the hessian entries changes with the children, and with the layout of any of their entries
+	std::size_t GetHessianEntriesLayoutVersion() const override
+	{
+		std::shared_lock<std::shared_mutex> lock(objective_functions_mutex_);
+		std::size_t hessian_entries_layout_version = ObjectiveFunctionBase::GetHessianEntriesLayoutVersion();
+		for (const auto& objective_function : objective_functions_)
+		{
+			hessian_entries_layout_version = std::max(hessian_entries_layout_version, objective_function->GetHessianEntriesLayoutVersion());
+		}
+
+		return hessian_entries_layout_version;
+	}
+
+	// The definition changes with the children, and with the definition of any of them
+	std::size_t GetDefinitionVersion() const override
+	{
+		std::shared_lock<std::shared_mutex> lock(objective_functions_mutex_);
+		std::size_t definition_version = ObjectiveFunctionBase::GetDefinitionVersion();
+		for (const auto& objective_function : objective_functions_)
+		{
+			definition_version = std::max(definition_version, objective_function->GetDefinitionVersion());
+		}
+
+		return definition_version;
 	}
 
 protected:
 	/**
 	 * Protected overrides
 	 */
+
+	// Children are unique, so their occurrences are looked up in the children index instead of scanning the dependencies
+	std::size_t CountDependency(const std::shared_ptr<UpdatableObject>& dependency) const override
+	{
+		if (std::dynamic_pointer_cast<ObjectiveFunctionType_>(dependency))
+		{
+			std::shared_lock<std::shared_mutex> lock(objective_functions_mutex_);
+			return objective_function_slots_.count(dependency.get());
+		}
+
+		return UpdatableObject::CountDependency(dependency);
+	}
+
+	// Children with zero weight (and any subtree reachable only through them) are not updated until their weight becomes nonzero
+	bool IsDependencyActive(const std::shared_ptr<UpdatableObject>& dependency) const override
+	{
+		const auto objective_function = std::dynamic_pointer_cast<ObjectiveFunctionType_>(dependency);
+		if (objective_function)
+		{
+			return objective_function->GetWeight() != 0;
+		}
+
+		return true;
+	}
+
 	void PreInitialize() override
 	{
+		std::shared_lock<std::shared_mutex> lock(objective_functions_mutex_);
 		for (const auto& objective_function : objective_functions_)
 		{
 			objective_function->Initialize();
@@ -167,28 +314,112 @@ protected:
 	}
 	
 private:
+	/**
+	 * Private type definitions
+	 */
+
+	// Positions of a child in the children array, in the dependencies array and in the list of children sharing its name
+	struct ObjectiveFunctionSlot
+	{
+		std::size_t objective_function_index;
+		std::size_t dependency_index;
+		std::size_t name_index;
+	};
+
+	/**
+	 * Private methods
+	 */
+	void InsertObjectiveFunction(const std::shared_ptr<ObjectiveFunctionType_>& objective_function)
+	{
+		auto& objective_functions = name_to_objective_functions_[objective_function->GetName()];
+		const ObjectiveFunctionSlot objective_function_slot{ objective_functions_.size(), this->dependencies_.size(), objective_functions.size() };
+		if (!objective_function_slots_.emplace(objective_function.get(), objective_function_slot).second)
+		{
+			throw std::exception("Objective function was already added");
+		}
+
+		objective_functions_.push_back(objective_function);
+		this->dependencies_.push_back(objective_function);
+		objective_functions.push_back(objective_function);
+	}
+
+	// Swap-and-pop removal of a child from the children array, the dependencies array and the names index
+	bool EraseObjectiveFunction(const std::shared_ptr<ObjectiveFunctionType_>& objective_function)
+	{
+		const auto objective_function_slot_it = objective_function_slots_.find(objective_function.get());
+		if (objective_function_slot_it == objective_function_slots_.end())
+		{
+			return false;
+		}
+
+		const ObjectiveFunctionSlot objective_function_slot = objective_function_slot_it->second;
+		objective_function_slots_.erase(objective_function_slot_it);
+
+		if (objective_function_slot.objective_function_index + 1 != objective_functions_.size())
+		{
+			objective_functions_[objective_function_slot.objective_function_index] = std::move(objective_functions_.back());
+			objective_function_slots_.at(objective_functions_[objective_function_slot.objective_function_index].get()).objective_function_index = objective_function_slot.objective_function_index;
+		}
+		objective_functions_.pop_back();
+
+		auto& dependencies = this->dependencies_;
+		if (objective_function_slot.dependency_index + 1 != dependencies.size())
+		{
+			dependencies[objective_function_slot.dependency_index] = std::move(dependencies.back());
+			const auto moved_objective_function_slot_it = objective_function_slots_.find(dependencies[objective_function_slot.dependency_index].get());
+			if (moved_objective_function_slot_it != objective_function_slots_.end())
+			{
+				moved_objective_function_slot_it->second.dependency_index = objective_function_slot.dependency_index;
+			}
+		}
+		dependencies.pop_back();
+
+		const auto name_index_it = name_to_objective_functions_.find(objective_function->GetName());
+		auto& objective_functions = name_index_it->second;
+		if (objective_function_slot.name_index + 1 != objective_functions.size())
+		{
+			objective_functions[objective_function_slot.name_index] = std::move(objective_functions.back());
+			objective_function_slots_.at(objective_functions[objective_function_slot.name_index].get()).name_index = objective_function_slot.name_index;
+		}
+		objective_functions.pop_back();
+
+		if (objective_functions.empty())
+		{
+			name_to_objective_functions_.erase(name_index_it);
+		}
+
+		return true;
+	}
 
 	/**
 	 * Private overrides
 	 */
 	void CalculateValue(double& f) override
 	{
+		std::shared_lock<std::shared_mutex> lock(objective_functions_mutex_);
 		f = 0;
 		for (const auto& objective_function : objective_functions_)
 		{
 			auto w = objective_function->GetWeight();
-			f += w * objective_function->GetValue();
+			if (w != 0)
+			{
+				f += w * objective_function->GetValue();
+			}
 		}
 	}
 
 	void CalculateValuePerVertex(VectorType_& f_per_vertex) override
 	{
+		std::shared_lock<std::shared_mutex> lock(objective_functions_mutex_);
 		f_per_vertex.setZero();
 		for (int64_t i = 0; i < objective_functions_.size(); i++)
 		{
 			auto& objective_function = objective_functions_.at(i);
 			auto w = objective_function->GetWeight();
-			objective_function->AddValuePerVertex(f_per_vertex, w);
+			if (w != 0)
+			{
+				objective_function->AddValuePerVertex(f_per_vertex, w);
+			}
 		}
 	}
 
@@ -199,23 +430,57 @@ private:
 
 	void CalculateGradient(VectorType_& g) override
 	{
+		std::shared_lock<std::shared_mutex> lock(objective_functions_mutex_);
 		g.setZero();
-		for(int64_t i = 0; i < objective_functions_.size(); i++)
+		const int64_t objective_functions_count = objective_functions_.size();
+		if (objective_functions_count < 2 * gradient_partitions_count_)
 		{
-			auto& objective_function = objective_functions_.at(i);
-			auto w = objective_function->GetWeight();
-			objective_function->AddGradient<VectorType_>(g, w);
+			for (int64_t i = 0; i < objective_functions_count; i++)
+			{
+				auto& objective_function = objective_functions_.at(i);
+				auto w = objective_function->GetWeight();
+				if (w != 0)
+				{
+					objective_function->AddGradient<VectorType_>(g, w);
+				}
+			}
+
+			return;
+		}
+
+		/**
+		 * Each partition accumulates a contiguous range of children into its own partial gradient, and the partial gradients
+		 * are then summed in partition order. Since the partitioning does not depend on the number of threads, the result is deterministic.
+		 */
+		gradient_partitions_.resize(gradient_partitions_count_);
+		tbb::parallel_for(static_cast<int64_t>(0), gradient_partitions_count_, [&](const int64_t partition_index)
+		{
+			auto& partial_g = gradient_partitions_[partition_index];
+			partial_g.resize(g.rows());
+			partial_g.setZero();
+
+			const int64_t begin = (partition_index * objective_functions_count) / gradient_partitions_count_;
+			const int64_t end = ((partition_index + 1) * objective_functions_count) / gradient_partitions_count_;
+			for (int64_t i = begin; i < end; i++)
+			{
+				auto& objective_function = objective_functions_[i];
+				auto w = objective_function->GetWeight();
+				if (w != 0)
+				{
+					objective_function->AddGradient<VectorType_>(partial_g, w);
+				}
+			}
+		});
+
+		for (const auto& partial_g : gradient_partitions_)
+		{
+			g += partial_g;
 		}
 	}
 
 	void CalculateTriplets(std::vector<Eigen::Triplet<double>>& triplets) override
 	{
-		triplets.clear();
-		for (const auto& objective_function : objective_functions_)
-		{
-			auto w = objective_function->GetWeight();
-			objective_function->AddTriplets(triplets, w);
-		}
+		// Empty implementation (children write their weighted hessian entries directly into the root hessian, see AddHessianEntries())
 	}
 
 	void InitializeTriplets(std::vector<Eigen::Triplet<double>>& triplets) override
@@ -226,7 +491,15 @@ private:
 	/**
 	 * Fields
 	 */
-	tbb::concurrent_vector<std::shared_ptr<ObjectiveFunctionType_>> objective_functions_;
+	std::vector<std::shared_ptr<ObjectiveFunctionType_>> objective_functions_;
+	std::unordered_map<const UpdatableObject*, ObjectiveFunctionSlot> objective_function_slots_;
+	std::unordered_map<std::string, std::vector<std::shared_ptr<ObjectiveFunctionType_>>> name_to_objective_functions_;
+
+	// Children may be added from within parallel loops, and from other threads while the objective is being updated
+	mutable std::shared_mutex objective_functions_mutex_;
+	mutable std::vector<int64_t> hessian_entries_offsets_;
+	std::vector<VectorType_> gradient_partitions_;
+	static constexpr int64_t gradient_partitions_count_ = 16;
 	bool parallel_update_;
 	bool enforce_children_psd_;
 };
@@ -4,11 +4,15 @@
 
 // STL includes
 #include <vector>
+#include <cmath>
 
 // Eigen includes
 #include <Eigen/Core>
 #include <Eigen/Sparse>
 
+// TBB includes
+#include <tbb/parallel_for.h>
+
 // LIBIGL includes
 #include <igl/doublearea.h>
 
@@ -43,55 +47,33 @@ private:
 	 */
 	void CalculateValue(double& f) override
 	{
-		bool inversions_exist = UpdateJ(X);
-
-		// E = ||J||^2 + ||J^-1||^2 = ||J||^2 + ||J||^2 / det(J)^2
-		Eigen::VectorXd dirichlet = a.cwiseAbs2() + b.cwiseAbs2() + c.cwiseAbs2() + d.cwiseAbs2();
-		Eigen::VectorXd invDirichlet = dirichlet.cwiseQuotient(detJuv.cwiseAbs2());
-		Efi = dirichlet + invDirichlet;
-
-		f = 0.5 * (Area.asDiagonal() * Efi).sum();
+		f = 0.5 * Area.dot(Efi);
 	}
 
 	void CalculateGradient(Eigen::VectorXd& g) override
 	{
-		bool inversions_exist = UpdateJ(X);
-		UpdateSSVDFunction();
-
-		Eigen::MatrixX2d invs = s.cwiseInverse();
-
-		g.conservativeResize(X.size());
+		g.conservativeResize(2 * numV);
 		g.setZero();
-		ComputeDenseSSVDDerivatives();
-
 		for (int fi = 0; fi < numF; ++fi)
 		{
-			double gS = s(fi, 0) - pow(invs(fi, 0), 3);
-			double gs = s(fi, 1) - pow(invs(fi, 1), 3);
-
-			if (bound > 0)
-			{
-				gS += gS / (bound - Efi(fi));
-				gs += gs / (bound - Efi(fi));
-			}
-
-			Eigen::Matrix<double, 6, 1> Dsdi0 = Dsd[0].col(fi);
-			Eigen::Matrix<double, 6, 1> Dsdi1 = Dsd[1].col(fi);
-			Eigen::Matrix<double, 6, 1> gi = Area(fi) * (Dsdi0 * gS + Dsdi1 * gs);
-
 			for (int vi = 0; vi < 6; ++vi)
 			{
-				g(Fuv(vi, fi)) += gi(vi);
+				g(Fuv(vi, fi)) += face_gradients_(vi, fi);
 			}
 		}
 	}
-	
-	void PreUpdate(const Eigen::VectorXd& x) override
+
+	void PreUpdate(const Eigen::VectorXd& x, const ObjectiveFunctionBase::UpdateOptions update_options) override
 	{
-		X = Eigen::Map<const Eigen::MatrixX2d>(x.data(), x.rows() >> 1, 2);
+		const bool calculate_gradient = (update_options & ObjectiveFunctionBase::UpdateOptions::Gradient) != ObjectiveFunctionBase::UpdateOptions::None;
+		const bool calculate_hessian = (update_options & ObjectiveFunctionBase::UpdateOptions::Hessian) != ObjectiveFunctionBase::UpdateOptions::None;
+
+		tbb::parallel_for(0, static_cast<int>(numF), [&](const int fi)
+		{
+			UpdateFace(x, fi, calculate_gradient, calculate_hessian);
+		});
 	}
 
-	
 	void PreInitialize() override
 	{
 		auto F = this->mesh_data_provider_->GetDomainFaces();
@@ -101,7 +83,6 @@ private:
 		auto D2 = this->mesh_data_provider_->GetD2();
 
 		auto Fs = this->mesh_data_provider_->GetImageFaces();
-		this->F = this->mesh_data_provider_->GetImageFaces();
 
 		numF = Fs.rows();
 		numV = this->mesh_data_provider_->GetImageVerticesCount();
@@ -110,22 +91,6 @@ private:
 		Fuv.topRows(3) = Fs.transpose();
 		Fuv.bottomRows(3) = Fuv.topRows(3) + Eigen::MatrixXi::Constant(3, numF, static_cast<int>(numV));
 
-		a.resize(numF);
-		b.resize(numF);
-		c.resize(numF);
-		d.resize(numF);
-		s.resize(numF, 2);
-		v.resize(numF, 4);
-		u.resize(numF, 4);
-
-		Dsd[0].resize(6, numF);
-		Dsd[1].resize(6, numF);
-
-		//Parameterization J mats resize
-		detJuv.resize(numF);
-		invdetJuv.resize(numF);
-		DdetJuv_DUV.resize(static_cast<int>(numF), static_cast<int>(numV * 2));
-
 		// compute init energy matrices
 		igl::doublearea(V, F, Area);
 		Area /= 2;
@@ -133,301 +98,182 @@ private:
 		D1d = D1.transpose();
 		D2d = D2.transpose();
 
-		//columns belong to different faces
-		a1d.resize(6, numF);
-		a2d.resize(6, numF);
-		b1d.resize(6, numF);
-		b2d.resize(6, numF);
-
-		a1d.topRows(3) = 0.5 * D1d;
-		a1d.bottomRows(3) = 0.5 * D2d;
-
-		a2d.topRows(3) = -0.5 * D2d;
-		a2d.bottomRows(3) = 0.5 * D1d;
-
-		b1d.topRows(3) = 0.5 * D1d;
-		b1d.bottomRows(3) = -0.5 * D2d;
-
-		b2d.topRows(3) = 0.5 * D2d;
-		b2d.bottomRows(3) = 0.5 * D1d;
-
-		Hi.resize(numF);
+		Efi.resize(numF);
+		face_gradients_.resize(6, numF);
+		face_hessians_.resize(21, numF);
 	}
 
 	void InitializeTriplets(std::vector<Eigen::Triplet<double>>& triplets) override
 	{
-		auto nfs = this->mesh_data_provider_->GetImageFaces().rows();
-		auto nvs = this->mesh_data_provider_->GetImageVerticesCount();
-		triplets.reserve(21 * nfs);
-		for (int i = 0; i < nfs; ++i)
+		triplets.reserve(21 * numF);
+		for (int i = 0; i < numF; ++i)
 		{
 			// for every face there is a 6x6 local hessian
 			// we only need the 21 values contained in the upper
 			// diagonal. they are access and also put into the
 			// big hessian in column order.
-
-			// base indices
-			int uhbr = 3 * i;		//upper_half_base_row
-			int lhbr = 3 * i + static_cast<int>(nvs); // lower_half_base_row 
-			int lhbc = 3 * i;		// left_half_base_col 
-			int rhbc = 3 * i + static_cast<int>(nvs); // right_half_base_col 
-
-			// first column
-			triplets.push_back(Eigen::Triplet<double>(uhbr, lhbc, 0));
-
-			// second column
-			triplets.push_back(Eigen::Triplet<double>(uhbr, lhbc + 1, 0));
-			triplets.push_back(Eigen::Triplet<double>(uhbr + 1, lhbc + 1, 0));
-
-			// third column
-			triplets.push_back(Eigen::Triplet<double>(uhbr, lhbc + 2, 0));
-			triplets.push_back(Eigen::Triplet<double>(uhbr + 1, lhbc + 2, 0));
-			triplets.push_back(Eigen::Triplet<double>(uhbr + 2, lhbc + 2, 0));
-
-			// fourth column
-			triplets.push_back(Eigen::Triplet<double>(uhbr, rhbc, 0));
-			triplets.push_back(Eigen::Triplet<double>(uhbr + 1, rhbc, 0));
-			triplets.push_back(Eigen::Triplet<double>(uhbr + 2, rhbc, 0));
-			triplets.push_back(Eigen::Triplet<double>(lhbr, rhbc, 0));
-
-			// fifth column
-			triplets.push_back(Eigen::Triplet<double>(uhbr, rhbc + 1, 0));
-			triplets.push_back(Eigen::Triplet<double>(uhbr + 1, rhbc + 1, 0));
-			triplets.push_back(Eigen::Triplet<double>(uhbr + 2, rhbc + 1, 0));
-			triplets.push_back(Eigen::Triplet<double>(lhbr, rhbc + 1, 0));
-			triplets.push_back(Eigen::Triplet<double>(lhbr + 1, rhbc + 1, 0));
-
-			// sixth column
-			triplets.push_back(Eigen::Triplet<double>(uhbr, rhbc + 2, 0));
-			triplets.push_back(Eigen::Triplet<double>(uhbr + 1, rhbc + 2, 0));
-			triplets.push_back(Eigen::Triplet<double>(uhbr + 2, rhbc + 2, 0));
-			triplets.push_back(Eigen::Triplet<double>(lhbr, rhbc + 2, 0));
-			triplets.push_back(Eigen::Triplet<double>(lhbr + 1, rhbc + 2, 0));
-			triplets.push_back(Eigen::Triplet<double>(lhbr + 2, rhbc + 2, 0));
-		}
-	}
-	
-	void CalculateRawTriplets(std::vector<Eigen::Triplet<double>>& triplets) override
-	{
-		auto lambda1 = [](double a) {return a - 1.0 / (a * a * a); };
-
-		// gradient of outer function in composition
-		Eigen::VectorXd gradfS = s.col(0).unaryExpr(lambda1);
-		Eigen::VectorXd gradfs = s.col(1).unaryExpr(lambda1);
-		auto lambda2 = [](double a) {return 1 + 3 / (a * a * a * a); };
-
-		// hessian of outer function in composition (diagonal)
-		Eigen::VectorXd HS = s.col(0).unaryExpr(lambda2);
-		Eigen::VectorXd Hs = s.col(1).unaryExpr(lambda2);
-
-		// similarity alpha
-		Eigen::VectorXd aY = 0.5 * (a + d);
-		Eigen::VectorXd bY = 0.5 * (c - b);
-
-		// anti similarity beta
-		Eigen::VectorXd cY = 0.5 * (a - d);
-		Eigen::VectorXd dY = 0.5 * (b + c);
-
-		#pragma omp parallel for
-		for (int i = 0; i < numF; ++i) 
-		{
-			//vectors of size 6
-			//svd derivatives
-			Eigen::Matrix<double, 6, 1> dSi = Dsd[0].col(i);
-			Eigen::Matrix<double, 6, 1> dsi = Dsd[1].col(i);
-			//cones constant coefficients (cone = |Ax|, A is a coefficient)
-			Eigen::Matrix<double, 6, 1> a1i = a1d.col(i);
-			Eigen::Matrix<double, 6, 1> a2i = a2d.col(i);
-			Eigen::Matrix<double, 6, 1> b1i = b1d.col(i);
-			Eigen::Matrix<double, 6, 1> b2i = b2d.col(i);
-			Hi[i] = Area(i) * ComputeConvexConcaveFaceHessian(
-				a1i,
-				a2i,
-				b1i,
-				b2i,
-				aY(i),
-				bY(i),
-				cY(i),
-				dY(i),
-				dSi,
-				dsi,
-				gradfS(i),
-				gradfs(i),
-				HS(i),
-				Hs(i));
-
-			int index2 = i * 21;
-			for (int a = 0; a < 6; ++a)
+			for (int column = 0; column < 6; ++column)
 			{
-				for (int b = 0; b <= a; ++b)
+				for (int row = 0; row <= column; ++row)
 				{
-					const_cast<double&>(triplets[index2++].value()) = Hi[i](a, b);
+					const int variable_index1 = Fuv(row, i);
+					const int variable_index2 = Fuv(column, i);
+					triplets.push_back(Eigen::Triplet<double>(std::min(variable_index1, variable_index2), std::max(variable_index1, variable_index2), 0));
 				}
 			}
 		}
-
-		std::size_t nf = F.rows();
-		#pragma omp parallel for
-		for (long i = 0; i < nf; i++)
-		{
-			std::size_t base = 21 * i;
-			const_cast<double&>(triplets[base].value()) += 1e-6;
-			const_cast<double&>(triplets[base + 2].value()) += 1e-6;
-			const_cast<double&>(triplets[base + 5].value()) += 1e-6;
-			const_cast<double&>(triplets[base + 9].value()) += 1e-6;
-			const_cast<double&>(triplets[base + 14].value()) += 1e-6;
-			const_cast<double&>(triplets[base + 20].value()) += 1e-6;
-		}
 	}
 
-	float Q_rsqrt(float number)
+	void CalculateRawTriplets(std::vector<Eigen::Triplet<double>>& triplets) override
 	{
-		const float x2 = number * 0.5F;
-		const float threehalfs = 1.5F;
-
-		union {
-			float f;
-			uint32_t i;
-		} conv = { number }; // member 'f' set to value of 'number'.
-		conv.i = 0x5f3759df - (conv.i >> 1);
-		conv.f *= (threehalfs - (x2 * conv.f * conv.f));
-		return conv.f;
+		tbb::parallel_for(0, static_cast<int>(numF), [&](const int i)
+		{
+			int index = i * 21;
+			for (int j = 0; j < 21; ++j)
+			{
+				const_cast<double&>(triplets[index++].value()) = face_hessians_(j, i);
+			}
+		});
 	}
-	
+
 	/**
 	 * Methods
 	 */
-	Eigen::Matrix<double, 6, 6> ComputeFaceConeHessian(
-		const Eigen::Matrix<double, 6, 1>& A1,
-		const Eigen::Matrix<double, 6, 1>& A2,
-		double a1x,
-		double a2x)
+
+	// Fused per-face kernel. Loads the face once and evaluates its jacobian, singular values, energy and (when requested) its gradient and projected hessian.
+	// The local variables of a face are ordered as: x0, x1, x2, y0, y1, y2
+	// Faces are evaluated one at a time (in parallel); vectorizing across faces, which would require a structure-of-arrays layout of the jacobians
+	// and of the derivative buffers, is out of scope.
+	void UpdateFace(const Eigen::VectorXd& x, const int fi, const bool calculate_gradient, const bool calculate_hessian)
 	{
-		double f2 = a1x * a1x + a2x * a2x;
-		double invf = 1.0 / sqrt(f2);
-		double invf3 = invf * invf * invf;
+		const Eigen::Vector3d D1 = D1d.col(fi);
+		const Eigen::Vector3d D2 = D2d.col(fi);
+		const Eigen::Vector3d X1(x.coeff(Fuv(0, fi)), x.coeff(Fuv(1, fi)), x.coeff(Fuv(2, fi)));
+		const Eigen::Vector3d X2(x.coeff(Fuv(3, fi)), x.coeff(Fuv(4, fi)), x.coeff(Fuv(5, fi)));
 
-		Eigen::Matrix<double, 6, 6> A1A1t = A1 * A1.transpose();
-		Eigen::Matrix<double, 6, 6> A2A2t = A2 * A2.transpose();
-		Eigen::Matrix<double, 6, 6> A1A2t = A1 * A2.transpose();
-		Eigen::Matrix<double, 6, 6> A2A1t = A1A2t.transpose();
+		// Jacobian J = [a b; c d]
+		const double a = D1.dot(X1);
+		const double b = D2.dot(X1);
+		const double c = D1.dot(X2);
+		const double d = D2.dot(X2);
 
-		double a2 = a1x * a1x;
-		double b2 = a2x * a2x;
-		double ab = a1x * a2x;
+		// E = ||J||^2 + ||J^-1||^2 = ||J||^2 + ||J||^2 / det(J)^2
+		const double det = a * d - b * c;
+		const double dirichlet = a * a + b * b + c * c + d * d;
+		Efi(fi) = dirichlet + dirichlet / (det * det);
 
-		return  (invf - invf3 * a2) * A1A1t + (invf - invf3 * b2) * A2A2t - invf3 * ab * (A1A2t + A2A1t);
-	}
+		if (!calculate_gradient && !calculate_hessian)
+		{
+			return;
+		}
 
-	Eigen::Matrix<double, 6, 6> ComputeConvexConcaveFaceHessian(
-		const Eigen::Matrix<double, 6, 1>& a1,
-		const Eigen::Matrix<double, 6, 1>& a2,
-		const Eigen::Matrix<double, 6, 1>& b1,
-		const Eigen::Matrix<double, 6, 1>& b2,
-		double aY,
-		double bY,
-		double cY,
-		double dY,
-		const Eigen::Matrix<double, 6, 1>& dSi,
-		const Eigen::Matrix<double, 6, 1>& dsi,
-		double gradfS,
-		double gradfs,
-		double HS,
-		double Hs)
-	{
-		// no multiplying by area in this function
+		// Closed-form signed singular values of J (see Utils::SSVD2x2()). J is split into its similarity part (e, h) and anti-similarity part (f, g),
+		// and the singular values are s[0] = q + r, s[1] = q - r, where q = |(e, h)| and r = |(f, g)|.
+		const double e = 0.5 * (a + d);
+		const double f = 0.5 * (a - d);
+		const double g = 0.5 * (b + c);
+		const double h = 0.5 * (c - b);
+		const double q = std::sqrt(e * e + h * h);
+		const double r = std::sqrt(f * f + g * g);
+		const double S = q + r;
+		const double s = q - r;
+
+		// Cosine and sine of the similarity and anti-similarity angles (atan2(0, 0) = 0 for a vanishing part)
+		const double cos_alpha = q > 0 ? e / q : 1;
+		const double sin_alpha = q > 0 ? h / q : 0;
+		const double cos_beta = r > 0 ? f / r : 1;
+		const double sin_beta = r > 0 ? g / r : 0;
+
+		// Singular values derivatives, dS/dx = dS/da * D1 + dS/db * D2 (x coordinates) and dS/dc * D1 + dS/dd * D2 (y coordinates)
+		Eigen::Matrix<double, 6, 1> dS;
+		dS << 0.5 * ((cos_alpha + cos_beta) * D1 + (sin_beta - sin_alpha) * D2),
+			  0.5 * ((sin_beta + sin_alpha) * D1 + (cos_alpha - cos_beta) * D2);
+
+		Eigen::Matrix<double, 6, 1> ds;
+		ds << 0.5 * ((cos_alpha - cos_beta) * D1 - (sin_beta + sin_alpha) * D2),
+			  0.5 * ((sin_alpha - sin_beta) * D1 + (cos_alpha + cos_beta) * D2);
+
+		// gradient of outer function in composition
+		double gS = S - 1.0 / (S * S * S);
+		double gs = s - 1.0 / (s * s * s);
+		if (bound > 0)
+		{
+			gS += gS / (bound - Efi(fi));
+			gs += gs / (bound - Efi(fi));
+		}
+
+		if (calculate_gradient)
+		{
+			face_gradients_.col(fi) = Area(fi) * (dS * gS + ds * gs);
+		}
+
+		if (!calculate_hessian)
+		{
+			return;
+		}
+
+		// hessian of outer function in composition (diagonal)
+		const double HS = 1 + 3 / (S * S * S * S);
+		const double Hs = 1 + 3 / (s * s * s * s);
 
 		// generalized gauss newton
-		Eigen::Matrix<double, 6, 6> H = HS * dSi * dSi.transpose() + Hs * dsi * dsi.transpose();
-		double walpha = gradfS + gradfs;
+		Eigen::Matrix<double, 6, 6> H = HS * dS * dS.transpose() + Hs * ds * ds.transpose();
+
+		// similarity alpha cone, |(e, h)|, with constant coefficients (cone = |Ax|, A is a coefficient)
+		const double walpha = gS + gs;
 		if (walpha > 0)
 		{
-			H += walpha * ComputeFaceConeHessian(a1, a2, aY, bY);
+			Eigen::Matrix<double, 6, 1> a1;
+			Eigen::Matrix<double, 6, 1> a2;
+			a1 << 0.5 * D1, 0.5 * D2;
+			a2 << -0.5 * D2, 0.5 * D1;
+			AddFaceConeHessian(a1, a2, e, h, walpha, H);
 		}
 
-		double wbeta = gradfS - gradfs;
+		// anti similarity beta cone, |(f, g)|
+		const double wbeta = gS - gs;
 		if (wbeta > 1e-7)
 		{
-			H += wbeta * ComputeFaceConeHessian(b1, b2, cY, dY);
+			Eigen::Matrix<double, 6, 1> b1;
+			Eigen::Matrix<double, 6, 1> b2;
+			b1 << 0.5 * D1, -0.5 * D2;
+			b2 << 0.5 * D2, 0.5 * D1;
+			AddFaceConeHessian(b1, b2, f, g, wbeta, H);
 		}
 
-		return H;
-	}
-
-	bool UpdateJ(const Eigen::MatrixX2d& x)
-	{
-		Eigen::Map<const Eigen::Matrix3Xd> X1(x.data(), 3, F.rows());
-		Eigen::Map<const Eigen::Matrix3Xd> X2(x.col(1).data(), 3, F.rows());
-		a = D1d.cwiseProduct(X1).colwise().sum();
-		b = D2d.cwiseProduct(X1).colwise().sum();
-		c = D1d.cwiseProduct(X2).colwise().sum();
-		d = D2d.cwiseProduct(X2).colwise().sum();
-		detJuv = a.cwiseProduct(d) - b.cwiseProduct(c);
-
-		return ((detJuv.array() < 0).any());
-	}
-	
-	void UpdateSSVDFunction()
-	{
-		#pragma omp parallel for
-		for (int i = 0; i < a.size(); i++)
+		int index = 0;
+		for (int column = 0; column < 6; ++column)
 		{
-			Eigen::Matrix2d A;
-			Eigen::Matrix2d U, S, V;
-			A << a[i], b[i], c[i], d[i];
-			Utils::SSVD2x2(A, U, S, V);
-			u.row(i) << U(0), U(1), U(2), U(3);
-			v.row(i) << V(0), V(1), V(2), V(3);
-			s.row(i) << S(0), S(3);
+			for (int row = 0; row <= column; ++row)
+			{
+				face_hessians_(index++, fi) = Area(fi) * H(row, column) + (row == column ? 1e-6 : 0);
+			}
 		}
 	}
-	
-	void ComputeDenseSSVDDerivatives()
+
+	// Adds w * hessian(|x * A1 + y * A2|) = w * ((A1 * A1^T + A2 * A2^T) / f - (x * A1 + y * A2) * (x * A1 + y * A2)^T / f^3), where f = |(x, y)|
+	static void AddFaceConeHessian(
+		const Eigen::Matrix<double, 6, 1>& A1,
+		const Eigen::Matrix<double, 6, 1>& A2,
+		const double x,
+		const double y,
+		const double w,
+		Eigen::Matrix<double, 6, 6>& H)
 	{
-		// different columns belong to different faces
-		Eigen::MatrixXd B(D1d * v.col(0).asDiagonal() + D2d * v.col(1).asDiagonal());
-		Eigen::MatrixXd C(D1d * v.col(2).asDiagonal() + D2d * v.col(3).asDiagonal());
-
-		Eigen::MatrixXd t1 = B * u.col(0).asDiagonal();
-		Eigen::MatrixXd t2 = B * u.col(1).asDiagonal();
-		Dsd[0].topRows(t1.rows()) = t1;
-		Dsd[0].bottomRows(t1.rows()) = t2;
-		t1 = C * u.col(2).asDiagonal();
-		t2 = C * u.col(3).asDiagonal();
-		Dsd[1].topRows(t1.rows()) = t1;
-		Dsd[1].bottomRows(t1.rows()) = t2;
+		const double invf = 1.0 / std::sqrt(x * x + y * y);
+		const double invf3 = invf * invf * invf;
+		const Eigen::Matrix<double, 6, 1> A = x * A1 + y * A2;
+		H += (w * invf) * (A1 * A1.transpose() + A2 * A2.transpose()) - (w * invf3) * (A * A.transpose());
 	}
 
 	/**
 	 * Private fields
 	 */
-	Eigen::MatrixX2d X;
-
 	double bound=0;
 
-	Eigen::MatrixX3i F;
-	Eigen::MatrixX2d V;
-
 	Eigen::DenseIndex numV;
-	Eigen::DenseIndex numE;
-	Eigen::DenseIndex numS;
 	Eigen::DenseIndex numF;
 
-	// Jacobian of the parameterization per face
-	Eigen::VectorXd a;
-	Eigen::VectorXd b;
-	Eigen::VectorXd c;
-	Eigen::VectorXd d;
-	Eigen::VectorXd detJuv; // (ad - bc)
-	Eigen::VectorXd invdetJuv; // 1 / (ad - bc)
-	Eigen::SparseMatrix<double> DdetJuv_DUV; // Jacobian of the function (detJuv) by UV
-
-	// Singular values
-	Eigen::MatrixX2d s; // Singular values s[0]>s[1]
-	Eigen::MatrixX4d v; // Singular vectors 
-	Eigen::MatrixX4d u; // Singular vectors 
-	Eigen::MatrixXd Dsd[2]; // Singular values dense derivatives s[0]>s[1]
-
 	// Efi = sum(Ef_dist.^2, 2), for data->Efi history
 	Eigen::VectorXd Efi;
 
@@ -436,16 +282,11 @@ private:
 	Eigen::VectorXd Area;
 
 	// Dense mesh derivative matrices
-	Eigen::Matrix3Xd D1d, D2d;										
-
-	// Constant matrices for cones calculation
-	Eigen::SparseMatrix<double> a1, a1t, a2, a2t, b1, b1t, b2, b2t;	
-
-	// Dense constant matrices for cones calculation
-	Eigen::MatrixXd a1d, a2d, b1d, b2d;
+	Eigen::Matrix3Xd D1d, D2d;
 
-	// Per face Hessians vector
-	std::vector<Eigen::Matrix<double,6,6>> Hi;
+	// Per face (weighted by area) gradients and upper triangles of the projected hessians, in column order
+	Eigen::Matrix<double, 6, Eigen::Dynamic> face_gradients_;
+	Eigen::Matrix<double, 21, Eigen::Dynamic> face_hessians_;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,23 @@
+#pragma once
+#ifndef OPTIMIZATION_LIB_DEFAULT_SOLVER_H
+#define OPTIMIZATION_LIB_DEFAULT_SOLVER_H
+
+// Eigen includes
+#include <Eigen/Core>
+
+// Optimization lib includes
+#ifdef OPTIMIZATION_LIB_WITH_PARDISO
+#include "./pardiso_solver.h"
+#else
+#include "./eigen_sparse_cholesky_solver.h"
+#endif
+
+// Sparse solver for the (row major, upper triangle) hessians of newton's method. MKL's pardiso is used, unless the optimization lib
+// is built without it (see the OPTIMIZATION_LIB_WITH_PARDISO option), in which case Eigen's sparse cholesky solver is used instead.
+#ifdef OPTIMIZATION_LIB_WITH_PARDISO
+using DefaultSolver = PardisoSolver;
+#else
+using DefaultSolver = EigenSparseCholeskySolver<Eigen::StorageOptions::RowMajor>;
+#endif
+
+#endif
\ No newline at end of file
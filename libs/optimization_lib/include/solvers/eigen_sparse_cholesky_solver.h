@@ -0,0 +1,89 @@
+#pragma once
+#ifndef OPTIMIZATION_LIB_EIGEN_SPARSE_CHOLESKY_SOLVER_H
+#define OPTIMIZATION_LIB_EIGEN_SPARSE_CHOLESKY_SOLVER_H
+
+// STL includes
+#include <algorithm>
+
+// Eigen includes
+#include <Eigen/Core>
+#include <Eigen/Sparse>
+
+// Optimization lib includes
+#include "./solver.h"
+
+// Sparse LDL^T solver for symmetric positive (semi-)definite systems, given by their upper triangle (including an explicit diagonal).
+// The symbolic factorization (fill-reducing ordering and elimination tree) is computed once by AnalyzePattern(), and every call to Solve() performs a numeric factorization only.
+// https://eigen.tuxfamily.org/dox/classEigen_1_1SimplicialLDLT.html
+template<Eigen::StorageOptions StorageOrder_>
+class EigenSparseCholeskySolver : public Solver<StorageOrder_>
+{
+public:
+	/**
+	 * Constructors and destructor
+	 */
+	EigenSparseCholeskySolver() :
+		Solver<StorageOrder_>()
+	{
+
+	}
+
+	virtual ~EigenSparseCholeskySolver()
+	{
+
+	}
+
+	/**
+	 * Public overrides
+	 */
+	void AnalyzePattern(const Eigen::SparseMatrix<double, StorageOrder_>& A) override
+	{
+		if constexpr (StorageOrder_ == Eigen::StorageOptions::ColMajor)
+		{
+			solver_.analyzePattern(A);
+		}
+		else
+		{
+			// The compressed arrays of a row-major upper triangle are exactly the compressed arrays of its column-major transpose (a lower triangle),
+			// so the transposed matrix is copied once here and only its values are refreshed on every numeric factorization
+			A_ = A.transpose();
+			solver_.analyzePattern(A_);
+		}
+	}
+
+	void Factorize(const Eigen::SparseMatrix<double, StorageOrder_>& A) override
+	{
+		// Compute the numerical factorization
+		if constexpr (StorageOrder_ == Eigen::StorageOptions::ColMajor)
+		{
+			solver_.factorize(A);
+		}
+		else
+		{
+			std::copy(A.valuePtr(), A.valuePtr() + A.nonZeros(), A_.valuePtr());
+			solver_.factorize(A_);
+		}
+	}
+
+	void Solve(const Eigen::VectorXd& b, Eigen::VectorXd& x) override
+	{
+		// Use the factors to solve the linear system
+		x = solver_.solve(b);
+	}
+
+	using Solver<StorageOrder_>::Solve;
+
+private:
+	/**
+	 * Private type definitions
+	 */
+	static constexpr int UpLo = StorageOrder_ == Eigen::StorageOptions::ColMajor ? Eigen::Upper : Eigen::Lower;
+
+	/**
+	 * Private fields
+	 */
+	Eigen::SparseMatrix<double, Eigen::StorageOptions::ColMajor> A_;
+	Eigen::SimplicialLDLT<Eigen::SparseMatrix<double, Eigen::StorageOptions::ColMajor>, UpLo, Eigen::AMDOrdering<int>> solver_;
+};
+
+#endif
\ No newline at end of file
@@ -2,6 +2,12 @@
 #ifndef OPTIMIZATION_LIB_PARDISO_SOLVER_H
 #define OPTIMIZATION_LIB_PARDISO_SOLVER_H
 
+// STL includes
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
 // Eigen includes
 #include <Eigen/Core>
 #include <Eigen/Sparse>
@@ -12,11 +18,16 @@
 #include "mkl_pardiso.h"
 
 // Optimization lib includes
+#include "../core/utils.h"
 #include "./solver.h"
 
 // https://software.intel.com/en-us/mkl-developer-reference-c-intel-mkl-pardiso-parallel-direct-sparse-solver-interface
+// The buffers of the (compressed, row major) matrix are passed to pardiso as is, and only its values are copied when factorized values are
+// kept (see Solver::SetKeepFactorizedValues()). Since the matrix is real and symmetric (mtype = 2), it must hold only its upper triangle, with an explicit diagonal (see ObjectiveFunction::InitializeHessianPattern()).
 class PardisoSolver : public Solver<Eigen::StorageOptions::RowMajor>
 {
+	static_assert(std::is_same<MKL_INT, Eigen::SparseMatrix<double, Eigen::StorageOptions::RowMajor>::StorageIndex>::value, "Pardiso's index type must match the storage index of the matrix, so its buffers can be passed without copies");
+
 public:
 	/**
 	 * Constructors and destructor
@@ -48,15 +59,8 @@ public:
 		mnum_ = 1;			/* Which factorization to use. */
 		msglvl_ = 0;		/* Do not print statistical information in file */
 		error_ = 0;			/* Initialize error flag */
-
-		/* ----------------------------------------------------------------*/
-		/* .. Initialize the internal solver memory pointer. This is only  */
-		/*   necessary for the FIRST call of the PARDISO solver.           */
-		/* ----------------------------------------------------------------*/
-		for (MKL_INT i = 0; i < 64; i++)
-		{
-			pt_[i] = 0;
-		}
+		symbolic_analysis_ = nullptr;
+		factorized_values_ = nullptr;
 	}
 
 	virtual ~PardisoSolver()
@@ -65,9 +69,19 @@ public:
 		/* .. Termination and release of memory. */
 		/* --------------------------------------*/
 
-		/* Release internal memory. */
-		phase_ = -1;
-		pardiso(pt_, &maxfct_, &mnum_, &mtype_, &phase_, &n_, &ddum_, ia_.get(), ja_.get(), &idum_, &nrhs_, iparm_, &msglvl_, &ddum_, &ddum_, &error_);
+		/* Release internal memory of all cached symbolic analyses. */
+		for (auto& symbolic_analysis : symbolic_analyses_)
+		{
+			ReleaseSymbolicAnalysis(*symbolic_analysis);
+		}
+	}
+
+	/**
+	 * Public getters
+	 */
+	std::size_t GetSymbolicAnalysesCount() const
+	{
+		return symbolic_analyses_.size();
 	}
 
 	/**
@@ -75,70 +89,180 @@ public:
 	 */
 	void AnalyzePattern(const Eigen::SparseMatrix<double, Eigen::StorageOptions::RowMajor>& A) override
 	{
-		n_ = A.rows();
-		ia_ = std::make_unique<MKL_INT[]>(A.outerSize() + 1);
-		ja_ = std::make_unique<MKL_INT[]>(A.nonZeros());
-		a_ = std::make_unique<double[]>(A.nonZeros());
+		/**
+		 * Reuse a previous symbolic analysis of the same sparsity pattern, if exists (the hash only filters out candidates, and the
+		 * pattern itself is compared to rule out collisions). The cached analyses are kept from the most to the least recently used.
+		 */
+		const std::size_t pattern_hash = Utils::GeneratePatternHash(A);
+		const auto symbolic_analysis_iterator = std::find_if(symbolic_analyses_.begin(), symbolic_analyses_.end(), [&](const std::unique_ptr<SymbolicAnalysis>& symbolic_analysis) {
+			return symbolic_analysis->pattern_hash == pattern_hash && HasPattern(*symbolic_analysis, A);
+		});
 
-		MKL_INT* ia = const_cast<MKL_INT*>(A.outerIndexPtr());
-		MKL_INT* ja = const_cast<MKL_INT*>(A.innerIndexPtr());
-		double* a = const_cast<double*>(A.valuePtr());
-
-		for (MKL_INT i = 0; i < A.outerSize() + 1; i++)
+		if (symbolic_analysis_iterator != symbolic_analyses_.end())
 		{
-			ia_[i] = ia[i];
+			std::rotate(symbolic_analyses_.begin(), symbolic_analysis_iterator, symbolic_analysis_iterator + 1);
+			symbolic_analysis_ = symbolic_analyses_.front().get();
+			return;
 		}
 
-		for (MKL_INT i = 0; i < A.nonZeros(); i++)
+		ValidateUpperTriangularPattern(A);
+
+		/**
+		 * Evict the least recently used symbolic analysis once the cache is full (it is never the current one, which is the most recently used)
+		 */
+		if (symbolic_analyses_.size() >= max_symbolic_analyses_count_)
 		{
-			ja_[i] = ja[i];
+			ReleaseSymbolicAnalysis(*symbolic_analyses_.back());
+			symbolic_analyses_.pop_back();
 		}
 
-		for (MKL_INT i = 0; i < A.nonZeros(); i++)
+		symbolic_analyses_.insert(symbolic_analyses_.begin(), std::make_unique<SymbolicAnalysis>());
+		symbolic_analysis_ = symbolic_analyses_.front().get();
+		auto& symbolic_analysis = *symbolic_analysis_;
+		symbolic_analysis.pattern_hash = pattern_hash;
+		symbolic_analysis.ia.assign(A.outerIndexPtr(), A.outerIndexPtr() + A.outerSize() + 1);
+		symbolic_analysis.ja.assign(A.innerIndexPtr(), A.innerIndexPtr() + A.nonZeros());
+
+		/* ----------------------------------------------------------------*/
+		/* .. Initialize the internal solver memory pointer. This is only  */
+		/*   necessary for the FIRST call of the PARDISO solver.           */
+		/* ----------------------------------------------------------------*/
+		for (MKL_INT i = 0; i < 64; i++)
 		{
-			a_[i] = 0;
+			symbolic_analysis.pt[i] = nullptr;
 		}
 
-		// TODO: Make sure that the main diagonal is explicitly specified (even with zeros if needed) and that the lower triangular part is omitted (in case of symmetric matrix)
+		symbolic_analysis.n = A.rows();
 
 		/* --------------------------------------------------------------------*/
 		/* .. Reordering and Symbolic Factorization. This step also allocates  */
 		/*    all memory that is necessary for the factorization.              */
 		/* --------------------------------------------------------------------*/
 		phase_ = 11;
-		pardiso(pt_, &maxfct_, &mnum_, &mtype_, &phase_, &n_, a_.get(), ia_.get(), ja_.get(), &idum_, &nrhs_, iparm_, &msglvl_, &ddum_, &ddum_, &error_);
+		pardiso(symbolic_analysis.pt, &maxfct_, &mnum_, &mtype_, &phase_, &symbolic_analysis.n, GetValues(A), GetRowIndices(A), GetColumnIndices(A), &idum_, &nrhs_, iparm_, &msglvl_, &ddum_, &ddum_, &error_);
 	}
 
-	void Solve(const Eigen::SparseMatrix<double, Eigen::StorageOptions::RowMajor>& A, const Eigen::VectorXd& b, Eigen::VectorXd& x) override
+	// Back substitution and iterative refinement read the factorized matrix again. Its pattern is read from the symbolic analysis, which keeps
+	// its own copy, and its values are read from A, unless they have to be kept (in which case only they are copied).
+	void Factorize(const Eigen::SparseMatrix<double, Eigen::StorageOptions::RowMajor>& A) override
 	{
-		double* a = const_cast<double*>(A.valuePtr());
-
-		#pragma omp parallel for
-		for (MKL_INT i = 0; i < A.nonZeros(); i++)
+		auto& symbolic_analysis = *symbolic_analysis_;
+		if (keep_factorized_values_)
 		{
-			a_[i] = a[i];
+			kept_factorized_values_.assign(A.valuePtr(), A.valuePtr() + A.nonZeros());
+			factorized_values_ = kept_factorized_values_.data();
+		}
+		else
+		{
+			factorized_values_ = GetValues(A);
 		}
 
 		/* ----------------------------*/
 		/* .. Numerical factorization. */
 		/* ----------------------------*/
 		phase_ = 22;
-		pardiso(pt_, &maxfct_, &mnum_, &mtype_, &phase_, &n_, a_.get(), ia_.get(), ja_.get(), &idum_, &nrhs_, iparm_, &msglvl_, &ddum_, &ddum_, &error_);
+		pardiso(symbolic_analysis.pt, &maxfct_, &mnum_, &mtype_, &phase_, &symbolic_analysis.n, factorized_values_, symbolic_analysis.ia.data(), symbolic_analysis.ja.data(), &idum_, &nrhs_, iparm_, &msglvl_, &ddum_, &ddum_, &error_);
+	}
+
+	void Solve(const Eigen::VectorXd& b, Eigen::VectorXd& x) override
+	{
+		auto& symbolic_analysis = *symbolic_analysis_;
 
 		/* -----------------------------------------------*/
 		/* .. Back substitution and iterative refinement. */
 		/* -----------------------------------------------*/
 		phase_ = 33;
-		pardiso(pt_, &maxfct_, &mnum_, &mtype_, &phase_, &n_, a_.get(), ia_.get(), ja_.get(), &idum_, &nrhs_, iparm_, &msglvl_, const_cast<double*>(b.data()), const_cast<double*>(x.data()), &error_);
+		pardiso(symbolic_analysis.pt, &maxfct_, &mnum_, &mtype_, &phase_, &symbolic_analysis.n, factorized_values_, symbolic_analysis.ia.data(), symbolic_analysis.ja.data(), &idum_, &nrhs_, iparm_, &msglvl_, const_cast<double*>(b.data()), const_cast<double*>(x.data()), &error_);
 	}
 
+	using Solver::Solve;
+
 private:
+	/**
+	 * Private type definitions
+	 */
+
+	// Reordering and symbolic factorization of a single sparsity pattern, along with pardiso's internal memory pointer
+	struct SymbolicAnalysis
+	{
+		std::size_t pattern_hash;
+		std::vector<MKL_INT> ia;
+		std::vector<MKL_INT> ja;
+		MKL_INT n;
+		void* pt[64];
+	};
+
+	/**
+	 * Private constants
+	 */
+
+	// Each cached symbolic analysis holds pardiso's memory for the factorization of its pattern, so only a few are kept
+	static constexpr std::size_t max_symbolic_analyses_count_ = 4;
+
+	/**
+	 * Private methods
+	 */
+
+	// Pardiso does not modify its input arrays, but takes them as non-const pointers
+	static double* GetValues(const Eigen::SparseMatrix<double, Eigen::StorageOptions::RowMajor>& A)
+	{
+		return const_cast<double*>(A.valuePtr());
+	}
+
+	static MKL_INT* GetRowIndices(const Eigen::SparseMatrix<double, Eigen::StorageOptions::RowMajor>& A)
+	{
+		return const_cast<MKL_INT*>(A.outerIndexPtr());
+	}
+
+	static MKL_INT* GetColumnIndices(const Eigen::SparseMatrix<double, Eigen::StorageOptions::RowMajor>& A)
+	{
+		return const_cast<MKL_INT*>(A.innerIndexPtr());
+	}
+
+	static bool HasPattern(const SymbolicAnalysis& symbolic_analysis, const Eigen::SparseMatrix<double, Eigen::StorageOptions::RowMajor>& A)
+	{
+		return
+			A.isCompressed() &&
+			symbolic_analysis.ia.size() == static_cast<std::size_t>(A.outerSize() + 1) &&
+			symbolic_analysis.ja.size() == static_cast<std::size_t>(A.nonZeros()) &&
+			std::equal(symbolic_analysis.ia.begin(), symbolic_analysis.ia.end(), A.outerIndexPtr()) &&
+			std::equal(symbolic_analysis.ja.begin(), symbolic_analysis.ja.end(), A.innerIndexPtr());
+	}
+
+	void ReleaseSymbolicAnalysis(SymbolicAnalysis& symbolic_analysis)
+	{
+		phase_ = -1;
+		pardiso(symbolic_analysis.pt, &maxfct_, &mnum_, &mtype_, &phase_, &symbolic_analysis.n, &ddum_, &idum_, &idum_, &idum_, &nrhs_, iparm_, &msglvl_, &ddum_, &ddum_, &error_);
+	}
+
+	// Each row of an upper triangular matrix with an explicit diagonal starts at its diagonal entry
+	static void ValidateUpperTriangularPattern(const Eigen::SparseMatrix<double, Eigen::StorageOptions::RowMajor>& A)
+	{
+		if (!A.isCompressed())
+		{
+			throw std::exception("Pardiso expects a compressed matrix");
+		}
+
+		const auto* outer_index_ptr = A.outerIndexPtr();
+		const auto* inner_index_ptr = A.innerIndexPtr();
+		for (Eigen::Index row = 0; row < A.outerSize(); row++)
+		{
+			if (outer_index_ptr[row] == outer_index_ptr[row + 1] || inner_index_ptr[outer_index_ptr[row]] != row)
+			{
+				throw std::exception("Pardiso expects an upper triangular matrix with an explicit diagonal");
+			}
+		}
+	}
+
 	/**
 	 * Private fields
 	 */
-	MKL_INT n_;
-	std::unique_ptr<MKL_INT[]> ia_;
-	std::unique_ptr<MKL_INT[]> ja_;
+	std::vector<std::unique_ptr<SymbolicAnalysis>> symbolic_analyses_;
+	SymbolicAnalysis* symbolic_analysis_;
+
+	// Values of the last factorized matrix (either its own buffer, or a copy of it, when factorized values are kept)
+	double* factorized_values_;
+	std::vector<double> kept_factorized_values_;
 	MKL_INT mtype_;
 	MKL_INT nrhs_;
 	MKL_INT iparm_[64];
@@ -149,8 +273,6 @@ private:
 	MKL_INT msglvl_;
 	MKL_INT idum_;
 	double ddum_;
-	std::unique_ptr<double[]> a_;
-	void* pt_[64];
 };
 
 #endif
\ No newline at end of file
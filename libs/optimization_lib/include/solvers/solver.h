@@ -10,7 +10,8 @@ template<Eigen::StorageOptions StorageOrder>
 class Solver
 {
 public:
-	Solver()
+	Solver() :
+		keep_factorized_values_(false)
 	{
 		
 	}
@@ -20,8 +21,30 @@ public:
 		
 	}
 
+	// Whether factorizations must stay valid after the values of the factorized matrix change (e.g., for a lagged newton method). Otherwise, some
+	// solvers refer to the factorized matrix (e.g. for iterative refinement) when solving, instead of copying its values.
+	void SetKeepFactorizedValues(const bool keep_factorized_values)
+	{
+		keep_factorized_values_ = keep_factorized_values;
+	}
+
 	virtual void AnalyzePattern(const Eigen::SparseMatrix<double, StorageOrder>& A) = 0;
-	virtual void Solve(const Eigen::SparseMatrix<double, StorageOrder>& A, const Eigen::VectorXd& b, Eigen::VectorXd& x) = 0;
+
+	// Computes the numerical factorization of A, whose pattern must have been analyzed. Unless factorized values are kept (see SetKeepFactorizedValues()),
+	// A must outlive the factorization and keep its values until the next call to Factorize().
+	virtual void Factorize(const Eigen::SparseMatrix<double, StorageOrder>& A) = 0;
+
+	// Solves A * x = b, using the factorization computed by the last call to Factorize()
+	virtual void Solve(const Eigen::VectorXd& b, Eigen::VectorXd& x) = 0;
+
+	void Solve(const Eigen::SparseMatrix<double, StorageOrder>& A, const Eigen::VectorXd& b, Eigen::VectorXd& x)
+	{
+		Factorize(A);
+		Solve(b, x);
+	}
+
+protected:
+	bool keep_factorized_values_;
 };
 
 #endif
\ No newline at end of file
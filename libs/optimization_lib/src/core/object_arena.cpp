@@ -0,0 +1,61 @@
+// Optimization lib includes
+#include <core/object_arena.h>
+
+ObjectArena::ObjectArena(const std::size_t initial_block_size) :
+	initial_block_size_(initial_block_size)
+{
+
+}
+
+ObjectArena::~ObjectArena()
+{
+
+}
+
+std::size_t ObjectArena::GetAllocatedBytes() const
+{
+	std::size_t allocated_bytes = 0;
+	for (const auto& region : regions_)
+	{
+		if (region)
+		{
+			allocated_bytes += region->GetAllocatedBytes();
+		}
+	}
+
+	return allocated_bytes;
+}
+
+const std::shared_ptr<ObjectArena::Region>& ObjectArena::GetLocalRegion()
+{
+	auto& region = regions_.local();
+	if (!region)
+	{
+		region = std::make_shared<Region>(initial_block_size_);
+	}
+
+	return region;
+}
+
+ObjectArena::Region::Region(const std::size_t initial_block_size) :
+	memory_resource_(initial_block_size),
+	allocated_bytes_(0)
+{
+
+}
+
+ObjectArena::Region::~Region()
+{
+
+}
+
+void* ObjectArena::Region::Allocate(const std::size_t bytes, const std::size_t alignment)
+{
+	allocated_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+	return memory_resource_.allocate(bytes, alignment);
+}
+
+std::size_t ObjectArena::Region::GetAllocatedBytes() const
+{
+	return allocated_bytes_.load(std::memory_order_relaxed);
+}
@@ -1,11 +1,18 @@
 // STL includes
 #include <algorithm>
+#include <unordered_set>
 
 // Optimization lib includes
 #include <core/updatable_object.h>
 
+std::atomic<std::size_t> UpdatableObject::dependency_graph_version_ = 0;
+
 UpdatableObject::UpdatableObject(const std::shared_ptr<MeshDataProvider>& mesh_data_provider) :
-	mesh_data_provider_(mesh_data_provider)
+	mesh_data_provider_(mesh_data_provider),
+	dependency_layers_version_(0),
+	eliminated_redundant_updates_count_(0),
+	dependency_graph_x_(nullptr),
+	dependency_graph_update_modifiers_(0)
 {
 	
 }
@@ -17,7 +24,8 @@ UpdatableObject::~UpdatableObject()
 
 void UpdatableObject::Initialize()
 {
-	InitializeDependencyLayers(dependency_layers_);
+	// The dependency graph is built lazily, by the first update of the object it is executed for (see UpdateDependencies()),
+	// so objects that are only updated as dependencies of others never build one
 }
 
 [[nodiscard]] std::shared_ptr<MeshDataProvider> UpdatableObject::GetMeshDataProvider() const
@@ -25,46 +33,272 @@ void UpdatableObject::Initialize()
 	return mesh_data_provider_;
 }
 
-const tbb::concurrent_vector<std::shared_ptr<UpdatableObject>>& UpdatableObject::GetDependencies() const
+const std::vector<std::shared_ptr<UpdatableObject>>& UpdatableObject::GetDependencies() const
 {
 	return dependencies_;
 }
 
-void UpdatableObject::InitializeDependencyLayers(std::vector<std::vector<std::shared_ptr<UpdatableObject>>>& dependency_layers)
+std::size_t UpdatableObject::GetEliminatedRedundantUpdatesCount() const
 {
-	dependency_layers_.clear();
-	for (const auto& dependency : dependencies_)
+	return eliminated_redundant_updates_count_;
+}
+
+void UpdatableObject::RefreshDependencyLayers()
+{
+	if (!dependency_graph_ || dependency_layers_version_ != dependency_graph_version_)
 	{
-		BuildDependencyLayers(dependency, dependency_layers);
+		RebuildDependencyGraph();
 	}
 }
 
-int UpdatableObject::BuildDependencyLayers(const std::shared_ptr<UpdatableObject>& updatable_object, std::vector<std::vector<std::shared_ptr<UpdatableObject>>>& dependency_layers) const
+void UpdatableObject::UpdateDependencies(const Eigen::VectorXd& x, const int32_t update_modifiers)
+{
+	RefreshDependencyLayers();
+
+	dependency_graph_x_ = &x;
+	dependency_graph_update_modifiers_ = update_modifiers;
+	dependency_graph_source_->try_put(tbb::flow::continue_msg());
+	dependency_graph_->wait_for_all();
+	dependency_graph_x_ = nullptr;
+}
+
+void UpdatableObject::InvalidateDependencyLayers()
 {
-	if(updatable_object->GetDependencies().empty())
+	dependency_graph_version_++;
+}
+
+bool UpdatableObject::IsDependencyActive(const std::shared_ptr<UpdatableObject>& dependency) const
+{
+	return true;
+}
+
+std::size_t UpdatableObject::CountDependency(const std::shared_ptr<UpdatableObject>& dependency) const
+{
+	return std::count(dependencies_.begin(), dependencies_.end(), dependency);
+}
+
+void UpdatableObject::RebuildDependencyGraph()
+{
+	dependency_layers_version_ = dependency_graph_version_;
+	std::vector<std::vector<std::shared_ptr<UpdatableObject>>> dependency_layers;
+
+	// Maps each visited object to its layer index and to the number of times it (and its dependencies) would have been
+	// scheduled if every path reaching it were followed
+	std::unordered_map<const UpdatableObject*, std::pair<int, std::size_t>> visited_objects;
+	std::size_t scheduled_updates_count = 0;
+	for (const auto& dependency : dependencies_)
 	{
-		if(dependency_layers.empty())
+		if (IsDependencyActive(dependency))
 		{
-			dependency_layers.resize(1);
+			BuildDependencyLayers(dependency, dependency_layers, visited_objects);
+			scheduled_updates_count += visited_objects.at(dependency.get()).second;
 		}
+	}
 
-		dependency_layers[0].push_back(updatable_object);
-		return 0;
+	eliminated_redundant_updates_count_ = scheduled_updates_count - visited_objects.size();
+	InitializeDependencyGraph(dependency_layers);
+}
+
+int UpdatableObject::BuildDependencyLayers(const std::shared_ptr<UpdatableObject>& updatable_object, std::vector<std::vector<std::shared_ptr<UpdatableObject>>>& dependency_layers, std::unordered_map<const UpdatableObject*, std::pair<int, std::size_t>>& visited_objects) const
+{
+	// Each object is placed once, no matter how many paths reach it
+	const auto visited_object = visited_objects.find(updatable_object.get());
+	if (visited_object != visited_objects.end())
+	{
+		return visited_object->second.first;
 	}
 
-	std::vector<int> heights;
+	// An object with no active dependencies is a leaf
+	int layer_index = 0;
+	std::size_t scheduled_updates_count = 1;
 	for (const auto& dependency : updatable_object->GetDependencies())
 	{
-		heights.push_back(BuildDependencyLayers(dependency, dependency_layers));
+		if (updatable_object->IsDependencyActive(dependency))
+		{
+			layer_index = std::max(layer_index, BuildDependencyLayers(dependency, dependency_layers, visited_objects) + 1);
+			scheduled_updates_count += visited_objects.at(dependency.get()).second;
+		}
 	}
 
-	const auto layer_index = (*std::max_element(heights.begin(), heights.end())) + 1;
-	const auto minimal_layers_count = layer_index + 1;
+	const std::size_t minimal_layers_count = layer_index + 1;
 	if (dependency_layers.size() < minimal_layers_count)
 	{
 		dependency_layers.resize(minimal_layers_count);
 	}
 	
 	dependency_layers[layer_index].push_back(updatable_object);
+	visited_objects[updatable_object.get()] = std::make_pair(layer_index, scheduled_updates_count);
 	return layer_index;
-}
\ No newline at end of file
+}
+
+void UpdatableObject::InitializeDependencyGraph(const std::vector<std::vector<std::shared_ptr<UpdatableObject>>>& dependency_layers)
+{
+	dependency_graph_nodes_.clear();
+	dependency_graph_source_.reset();
+	dependency_graph_ = std::make_unique<tbb::flow::graph>();
+	dependency_graph_source_ = std::make_unique<tbb::flow::broadcast_node<tbb::flow::continue_msg>>(*dependency_graph_);
+
+	// Since every dependency lies in a lower layer than its dependents, the nodes of its dependencies are always created first
+	for (const auto& dependency_layer : dependency_layers)
+	{
+		for (const auto& updatable_object : dependency_layer)
+		{
+			AddDependencyGraphNode(updatable_object);
+		}
+	}
+
+	for (const auto& dependency : GetDistinctActiveDependencies(*this))
+	{
+		dependency_graph_nodes_.at(dependency.get()).successors_count++;
+	}
+}
+
+bool UpdatableObject::IsDependencyGraphPatchable() const
+{
+	// The dependency graph has to be up to date, except for the single change being patched
+	return dependency_graph_ && (dependency_layers_version_ + 1 == dependency_graph_version_);
+}
+
+UpdatableObject::DependencyGraphNode* UpdatableObject::FindDependencyGraphNode(const UpdatableObject& dependent)
+{
+	const auto dependency_graph_node = dependency_graph_nodes_.find(&dependent);
+	if (dependency_graph_node == dependency_graph_nodes_.end())
+	{
+		return nullptr;
+	}
+
+	return &dependency_graph_node->second;
+}
+
+UpdatableObject::DependencyGraphNode& UpdatableObject::AddDependencyGraphNode(const std::shared_ptr<UpdatableObject>& updatable_object)
+{
+	UpdatableObject* object = updatable_object.get();
+	const auto existing_dependency_graph_node = dependency_graph_nodes_.find(object);
+	if (existing_dependency_graph_node != dependency_graph_nodes_.end())
+	{
+		return existing_dependency_graph_node->second;
+	}
+
+	// The nodes of the dependencies are created (or reused) first
+	const auto dependencies = GetDistinctActiveDependencies(*object);
+	for (const auto& dependency : dependencies)
+	{
+		AddDependencyGraphNode(dependency).successors_count++;
+	}
+
+	auto& dependency_graph_node = dependency_graph_nodes_[object];
+	dependency_graph_node.node = std::make_unique<tbb::flow::continue_node<tbb::flow::continue_msg>>(*dependency_graph_, [this, object](const tbb::flow::continue_msg&) {
+		object->Update(*dependency_graph_x_, dependency_graph_update_modifiers_);
+	});
+	dependency_graph_node.predecessors_count = dependencies.size();
+	dependency_graph_node.successors_count = 0;
+
+	for (const auto& dependency : dependencies)
+	{
+		tbb::flow::make_edge(*dependency_graph_nodes_.at(dependency.get()).node, *dependency_graph_node.node);
+	}
+
+	if (dependencies.empty())
+	{
+		tbb::flow::make_edge(*dependency_graph_source_, *dependency_graph_node.node);
+	}
+
+	return dependency_graph_node;
+}
+
+void UpdatableObject::ReleaseDependencyGraphNode(const std::shared_ptr<UpdatableObject>& updatable_object)
+{
+	auto& dependency_graph_node = dependency_graph_nodes_.at(updatable_object.get());
+	dependency_graph_node.successors_count--;
+	if (dependency_graph_node.successors_count > 0)
+	{
+		return;
+	}
+
+	// The object is no longer reachable, so it is detached from its dependencies (which are released in turn)
+	if (dependency_graph_node.predecessors_count == 0)
+	{
+		tbb::flow::remove_edge(*dependency_graph_source_, *dependency_graph_node.node);
+	}
+
+	for (const auto& dependency : GetDistinctActiveDependencies(*updatable_object))
+	{
+		tbb::flow::remove_edge(*dependency_graph_nodes_.at(dependency.get()).node, *dependency_graph_node.node);
+		ReleaseDependencyGraphNode(dependency);
+	}
+
+	dependency_graph_nodes_.erase(updatable_object.get());
+}
+
+std::vector<std::shared_ptr<UpdatableObject>> UpdatableObject::GetDistinctActiveDependencies(const UpdatableObject& updatable_object)
+{
+	std::vector<std::shared_ptr<UpdatableObject>> dependencies;
+	std::unordered_set<const UpdatableObject*> visited_dependencies;
+	for (const auto& dependency : updatable_object.GetDependencies())
+	{
+		if (updatable_object.IsDependencyActive(dependency) && visited_dependencies.insert(dependency.get()).second)
+		{
+			dependencies.push_back(dependency);
+		}
+	}
+
+	return dependencies;
+}
+
+void UpdatableObject::OnDependencyAdded(const UpdatableObject& dependent, const std::shared_ptr<UpdatableObject>& dependency)
+{
+	if (!IsDependencyGraphPatchable())
+	{
+		return;
+	}
+
+	// Nothing to patch if the dependent is not part of the graph, if the new dependency is inactive, or if it was already a dependency of the dependent
+	DependencyGraphNode* dependent_graph_node = (&dependent == this) ? nullptr : FindDependencyGraphNode(dependent);
+	const bool is_dependent_in_graph = (&dependent == this) || (dependent_graph_node != nullptr);
+	const auto dependency_occurrences = dependent.CountDependency(dependency);
+	if (is_dependent_in_graph && dependent.IsDependencyActive(dependency) && (dependency_occurrences == 1))
+	{
+		AddDependencyGraphNode(dependency).successors_count++;
+		if (dependent_graph_node)
+		{
+			if (dependent_graph_node->predecessors_count == 0)
+			{
+				tbb::flow::remove_edge(*dependency_graph_source_, *dependent_graph_node->node);
+			}
+
+			tbb::flow::make_edge(*dependency_graph_nodes_.at(dependency.get()).node, *dependent_graph_node->node);
+			dependent_graph_node->predecessors_count++;
+		}
+	}
+
+	dependency_layers_version_ = dependency_graph_version_;
+}
+
+void UpdatableObject::OnDependencyRemoved(const UpdatableObject& dependent, const std::shared_ptr<UpdatableObject>& dependency)
+{
+	if (!IsDependencyGraphPatchable())
+	{
+		return;
+	}
+
+	// Nothing to patch if the dependent is not part of the graph, if the removed dependency was inactive, or if it is still a dependency of the dependent
+	DependencyGraphNode* dependent_graph_node = (&dependent == this) ? nullptr : FindDependencyGraphNode(dependent);
+	const bool is_dependent_in_graph = (&dependent == this) || (dependent_graph_node != nullptr);
+	const auto dependency_occurrences = dependent.CountDependency(dependency);
+	if (is_dependent_in_graph && dependent.IsDependencyActive(dependency) && (dependency_occurrences == 0))
+	{
+		if (dependent_graph_node)
+		{
+			tbb::flow::remove_edge(*dependency_graph_nodes_.at(dependency.get()).node, *dependent_graph_node->node);
+			dependent_graph_node->predecessors_count--;
+			if (dependent_graph_node->predecessors_count == 0)
+			{
+				tbb::flow::make_edge(*dependency_graph_source_, *dependent_graph_node->node);
+			}
+		}
+
+		ReleaseDependencyGraphNode(dependency);
+	}
+
+	dependency_layers_version_ = dependency_graph_version_;
+}
@@ -0,0 +1,76 @@
+// Optimization lib includes
+#include <data_providers/data_provider_registry.h>
+#include <core/object_arena.h>
+
+DataProviderRegistry::DataProviderRegistry() :
+	reused_data_providers_count_(0)
+{
+
+}
+
+DataProviderRegistry::~DataProviderRegistry()
+{
+
+}
+
+std::shared_ptr<EmptyDataProvider> DataProviderRegistry::GetEmptyDataProvider(const std::shared_ptr<MeshDataProvider>& mesh_data_provider)
+{
+	auto& registry = mesh_data_provider->GetDataProviderRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex_);
+	if (auto empty_data_provider = registry.empty_data_provider_.lock())
+	{
+		registry.reused_data_providers_count_++;
+		return empty_data_provider;
+	}
+
+	auto empty_data_provider = std::make_shared<EmptyDataProvider>(mesh_data_provider);
+	registry.empty_data_provider_ = empty_data_provider;
+	return empty_data_provider;
+}
+
+std::shared_ptr<CoordinateDataProvider> DataProviderRegistry::GetCoordinateDataProvider(const std::shared_ptr<MeshDataProvider>& mesh_data_provider, const RDS::VertexIndex vertex_index, const RDS::CoordinateType coordinate_type)
+{
+	auto& registry = mesh_data_provider->GetDataProviderRegistry();
+	return registry.GetOrCreate(registry.coordinate_data_providers_, std::make_pair(vertex_index, coordinate_type), [&]() {
+		return mesh_data_provider->GetObjectArena().MakeShared<CoordinateDataProvider>(mesh_data_provider, vertex_index, coordinate_type);
+	});
+}
+
+std::shared_ptr<CoordinateDiffDataProvider> DataProviderRegistry::GetCoordinateDiffDataProvider(const std::shared_ptr<MeshDataProvider>& mesh_data_provider, const RDS::VertexIndex vertex1_index, const RDS::VertexIndex vertex2_index, const RDS::CoordinateType coordinate_type)
+{
+	auto& registry = mesh_data_provider->GetDataProviderRegistry();
+	return registry.GetOrCreate(registry.coordinate_diff_data_providers_, std::make_tuple(vertex1_index, vertex2_index, coordinate_type), [&]() {
+		return mesh_data_provider->GetObjectArena().MakeShared<CoordinateDiffDataProvider>(mesh_data_provider, vertex1_index, vertex2_index, coordinate_type);
+	});
+}
+
+std::shared_ptr<EdgePairDataProvider> DataProviderRegistry::GetEdgePairDataProvider(const std::shared_ptr<MeshDataProvider>& mesh_data_provider, const RDS::EdgePairDescriptor& edge_pair_descriptor)
+{
+	auto& registry = mesh_data_provider->GetDataProviderRegistry();
+	return registry.GetOrCreate(registry.edge_pair_data_providers_, edge_pair_descriptor, [&]() {
+		return mesh_data_provider->GetObjectArena().MakeShared<EdgePairDataProvider>(mesh_data_provider, edge_pair_descriptor);
+	});
+}
+
+std::shared_ptr<FaceFanDataProvider> DataProviderRegistry::GetFaceFanDataProvider(const std::shared_ptr<MeshDataProvider>& mesh_data_provider, const RDS::FaceFan& face_fan)
+{
+	auto& registry = mesh_data_provider->GetDataProviderRegistry();
+	return registry.GetOrCreate(registry.face_fan_data_providers_, face_fan, [&]() {
+		return mesh_data_provider->GetObjectArena().MakeShared<FaceFanDataProvider>(mesh_data_provider, face_fan);
+	});
+}
+
+void DataProviderRegistry::Clear()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	empty_data_provider_.reset();
+	ClearDataProviders(coordinate_data_providers_);
+	ClearDataProviders(coordinate_diff_data_providers_);
+	ClearDataProviders(edge_pair_data_providers_);
+	ClearDataProviders(face_fan_data_providers_);
+}
+
+std::size_t DataProviderRegistry::GetReusedDataProvidersCount() const
+{
+	return reused_data_providers_count_;
+}
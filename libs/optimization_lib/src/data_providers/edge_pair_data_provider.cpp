@@ -10,15 +10,15 @@ EdgePairDataProvider::EdgePairDataProvider(const std::shared_ptr<MeshDataProvide
 	edge2_v1_index_ = edge_pair_descriptor.second.first;
 	edge2_v2_index_ = edge_pair_descriptor.second.second;
 	
-	edge1_v1_x_index_ = mesh_data_provider->GetXVariableIndex(edge_pair_descriptor.first.first);
-	edge1_v1_y_index_ = mesh_data_provider->GetYVariableIndex(edge_pair_descriptor.first.first);
-	edge1_v2_x_index_ = mesh_data_provider->GetXVariableIndex(edge_pair_descriptor.first.second);
-	edge1_v2_y_index_ = mesh_data_provider->GetYVariableIndex(edge_pair_descriptor.first.second);
+	variable_indices_.coeffRef(LocalVariableIndex::Edge1Vertex1X) = mesh_data_provider->GetXVariableIndex(edge_pair_descriptor.first.first);
+	variable_indices_.coeffRef(LocalVariableIndex::Edge1Vertex1Y) = mesh_data_provider->GetYVariableIndex(edge_pair_descriptor.first.first);
+	variable_indices_.coeffRef(LocalVariableIndex::Edge1Vertex2X) = mesh_data_provider->GetXVariableIndex(edge_pair_descriptor.first.second);
+	variable_indices_.coeffRef(LocalVariableIndex::Edge1Vertex2Y) = mesh_data_provider->GetYVariableIndex(edge_pair_descriptor.first.second);
 
-	edge2_v1_x_index_ = mesh_data_provider->GetXVariableIndex(edge_pair_descriptor.second.first);
-	edge2_v1_y_index_ = mesh_data_provider->GetYVariableIndex(edge_pair_descriptor.second.first);
-	edge2_v2_x_index_ = mesh_data_provider->GetXVariableIndex(edge_pair_descriptor.second.second);
-	edge2_v2_y_index_ = mesh_data_provider->GetYVariableIndex(edge_pair_descriptor.second.second);
+	variable_indices_.coeffRef(LocalVariableIndex::Edge2Vertex1X) = mesh_data_provider->GetXVariableIndex(edge_pair_descriptor.second.first);
+	variable_indices_.coeffRef(LocalVariableIndex::Edge2Vertex1Y) = mesh_data_provider->GetYVariableIndex(edge_pair_descriptor.second.first);
+	variable_indices_.coeffRef(LocalVariableIndex::Edge2Vertex2X) = mesh_data_provider->GetXVariableIndex(edge_pair_descriptor.second.second);
+	variable_indices_.coeffRef(LocalVariableIndex::Edge2Vertex2Y) = mesh_data_provider->GetYVariableIndex(edge_pair_descriptor.second.second);
 
 	image_edge_1_index_ = mesh_data_provider->GetImageEdgeIndex(edge_pair_descriptor.first);
 	image_edge_2_index_ = mesh_data_provider->GetImageEdgeIndex(edge_pair_descriptor.second);
@@ -32,20 +32,17 @@ EdgePairDataProvider::~EdgePairDataProvider()
 
 void EdgePairDataProvider::Update(const Eigen::VectorXd& x)
 {
-	variables_.coeffRef(edge1_v2_x_index_) = x(edge1_v2_x_index_);
-	variables_.coeffRef(edge1_v1_x_index_) = x(edge1_v1_x_index_);
-	variables_.coeffRef(edge1_v2_y_index_) = x(edge1_v2_y_index_);
-	variables_.coeffRef(edge1_v1_y_index_) = x(edge1_v1_y_index_);
-	variables_.coeffRef(edge2_v2_x_index_) = x(edge2_v2_x_index_);
-	variables_.coeffRef(edge2_v1_x_index_) = x(edge2_v1_x_index_);
-	variables_.coeffRef(edge2_v2_y_index_) = x(edge2_v2_y_index_);
-	variables_.coeffRef(edge2_v1_y_index_) = x(edge2_v1_y_index_);
-	
-	edge1_.coeffRef(0) = x(edge1_v2_x_index_) - x(edge1_v1_x_index_);
-	edge1_.coeffRef(1) = x(edge1_v2_y_index_) - x(edge1_v1_y_index_);
+	for (int32_t i = 0; i < LocalVariableIndex::Count_; i++)
+	{
+		variable_values_.coeffRef(i) = x.coeff(variable_indices_.coeff(i));
+	}
+
+	const auto& v = variable_values_;
+	edge1_.coeffRef(0) = v.coeff(LocalVariableIndex::Edge1Vertex2X) - v.coeff(LocalVariableIndex::Edge1Vertex1X);
+	edge1_.coeffRef(1) = v.coeff(LocalVariableIndex::Edge1Vertex2Y) - v.coeff(LocalVariableIndex::Edge1Vertex1Y);
 	
-	edge2_.coeffRef(0) = x(edge2_v2_x_index_) - x(edge2_v1_x_index_);
-	edge2_.coeffRef(1) = x(edge2_v2_y_index_) - x(edge2_v1_y_index_);
+	edge2_.coeffRef(0) = v.coeff(LocalVariableIndex::Edge2Vertex2X) - v.coeff(LocalVariableIndex::Edge2Vertex1X);
+	edge2_.coeffRef(1) = v.coeff(LocalVariableIndex::Edge2Vertex2Y) - v.coeff(LocalVariableIndex::Edge2Vertex1Y);
 	
 	edge1_x_diff_ = edge1_.coeffRef(0);
 	edge1_y_diff_ = edge1_.coeffRef(1);
@@ -63,10 +60,10 @@ void EdgePairDataProvider::Update(const Eigen::VectorXd& x)
 	edge1_quadrupled_norm_ = edge1_squared_norm_ * edge1_squared_norm_;
 	edge2_quadrupled_norm_ = edge2_squared_norm_ * edge2_squared_norm_;
 
-	vertex1_x_diff_ = x(edge1_v1_x_index_) - x(edge2_v1_x_index_);
-	vertex2_x_diff_ = x(edge1_v2_x_index_) - x(edge2_v2_x_index_);
-	vertex1_y_diff_ = x(edge1_v1_y_index_) - x(edge2_v1_y_index_);
-	vertex2_y_diff_ = x(edge1_v2_y_index_) - x(edge2_v2_y_index_);
+	vertex1_x_diff_ = v.coeff(LocalVariableIndex::Edge1Vertex1X) - v.coeff(LocalVariableIndex::Edge2Vertex1X);
+	vertex2_x_diff_ = v.coeff(LocalVariableIndex::Edge1Vertex2X) - v.coeff(LocalVariableIndex::Edge2Vertex2X);
+	vertex1_y_diff_ = v.coeff(LocalVariableIndex::Edge1Vertex1Y) - v.coeff(LocalVariableIndex::Edge2Vertex1Y);
+	vertex2_y_diff_ = v.coeff(LocalVariableIndex::Edge1Vertex2Y) - v.coeff(LocalVariableIndex::Edge2Vertex2Y);
 }
 
 void EdgePairDataProvider::Update(const Eigen::VectorXd& x, int32_t update_modifiers)
@@ -6,6 +6,18 @@ FaceFanDataProvider::FaceFanDataProvider(const std::shared_ptr<MeshDataProvider>
 	face_fan_(face_fan)
 {
 	domain_vertex_index_ = this->mesh_data_provider_->GetDomainVertexIndex(face_fan_[0].first);
+
+	slice_variable_indices_.resize(face_fan_.size());
+	for (std::size_t face_fan_index = 0; face_fan_index < face_fan_.size(); face_fan_index++)
+	{
+		const RDS::FaceFanSlice& face_fan_slice = face_fan_[face_fan_index];
+		const RDS::VertexIndex v_index[3] = { face_fan_slice.first, face_fan_slice.second.first, face_fan_slice.second.second };
+		for (int i = 0; i < 3; i++)
+		{
+			slice_variable_indices_[face_fan_index].coeffRef(2 * i) = this->mesh_data_provider_->GetXVariableIndex(v_index[i]);
+			slice_variable_indices_[face_fan_index].coeffRef(2 * i + 1) = this->mesh_data_provider_->GetYVariableIndex(v_index[i]);
+		}
+	}
 }
 
 FaceFanDataProvider::~FaceFanDataProvider()
@@ -16,31 +28,16 @@ FaceFanDataProvider::~FaceFanDataProvider()
 void FaceFanDataProvider::Update(const Eigen::VectorXd& x)
 {
 	double accumulated_angle = 0;
-	const auto face_fan_count = face_fan_.size();
+	const auto face_fan_count = slice_variable_indices_.size();
 	for (std::size_t face_fan_index = 0; face_fan_index < face_fan_count; face_fan_index++)
 	{
-		RDS::FaceFanSlice face_fan_slice = face_fan_[face_fan_index];
-
-		RDS::VertexIndex v_index[3];
-		v_index[0] = face_fan_slice.first;
-		v_index[1] = face_fan_slice.second.first;
-		v_index[2] = face_fan_slice.second.second;
+		const auto& variable_indices = slice_variable_indices_[face_fan_index];
 
 		Eigen::Vector2d v[3];
-
 		for(int i = 0; i < 3; i++)
 		{
-			const RDS::SparseVariableIndex v_x_index = mesh_data_provider_->GetXVariableIndex(v_index[i]);
-			const RDS::SparseVariableIndex v_y_index = mesh_data_provider_->GetYVariableIndex(v_index[i]);
-
-			const double v_x = x.coeffRef(v_x_index);
-			const double v_y = x.coeffRef(v_y_index);
-
-			variables_.coeffRef(v_x_index) = v_x;
-			variables_.coeffRef(v_y_index) = v_y;
-
-			v[i].coeffRef(0) = v_x;
-			v[i].coeffRef(1) = v_y;
+			v[i].coeffRef(0) = x.coeff(variable_indices.coeff(2 * i));
+			v[i].coeffRef(1) = x.coeff(variable_indices.coeff(2 * i + 1));
 		}
 
 		Eigen::Vector2d e1 = v[1] - v[0];
@@ -0,0 +1,31 @@
+// Optimization lib includes
+#include <data_providers/mesh_data_provider.h>
+#include <data_providers/data_provider_registry.h>
+#include <core/object_arena.h>
+
+MeshDataProvider::MeshDataProvider() :
+	data_provider_registry_(std::make_unique<DataProviderRegistry>()),
+	object_arena_(std::make_shared<ObjectArena>())
+{
+
+}
+
+MeshDataProvider::~MeshDataProvider()
+{
+
+}
+
+DataProviderRegistry& MeshDataProvider::GetDataProviderRegistry() const
+{
+	return *data_provider_registry_;
+}
+
+ObjectArena& MeshDataProvider::GetObjectArena() const
+{
+	return *object_arena_;
+}
+
+void MeshDataProvider::ResetObjectArena()
+{
+	object_arena_ = std::make_shared<ObjectArena>();
+}
@@ -7,6 +7,7 @@
 
 // Optimization library includes
 #include <data_providers//mesh_wrapper.h>
+#include <data_providers/data_provider_registry.h>
 
 // LIBIGL includes
 #include <igl/slice.h>
@@ -869,6 +870,10 @@ MeshWrapper::ModelFileType MeshWrapper::GetModelFileType(const std::string& mode
 
 void MeshWrapper::Initialize()
 {
+	// Interned data providers refer to the vertex indices of the previous model
+	GetDataProviderRegistry().Clear();
+	ResetObjectArena();
+
 	NormalizeVertices(v_dom_);
 	ComputeEdges(f_dom_, e_dom_);
 	ComputeEdgeDescriptorMap(e_dom_, ed_dom_2_ei_dom_);
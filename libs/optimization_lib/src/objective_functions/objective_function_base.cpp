@@ -2,8 +2,13 @@
 #include <core/updatable_object.h>
 #include <objective_functions/objective_function_base.h>
 
+std::atomic<std::size_t> ObjectiveFunctionBase::hessian_entries_layout_versions_sequence_ = 0;
+std::atomic<std::size_t> ObjectiveFunctionBase::definition_versions_sequence_ = 0;
+
 ObjectiveFunctionBase::ObjectiveFunctionBase(const std::shared_ptr<MeshDataProvider>& mesh_data_provider) :
-	UpdatableObject(mesh_data_provider)
+	UpdatableObject(mesh_data_provider),
+	hessian_entries_layout_version_(++hessian_entries_layout_versions_sequence_),
+	definition_version_(0)
 {
 	
 }
@@ -13,6 +18,27 @@ ObjectiveFunctionBase::~ObjectiveFunctionBase()
 	
 }
 
+void ObjectiveFunctionBase::InvalidateHessianEntriesLayout()
+{
+	hessian_entries_layout_version_ = ++hessian_entries_layout_versions_sequence_;
+	InvalidateDefinition();
+}
+
+void ObjectiveFunctionBase::InvalidateDefinition()
+{
+	definition_version_ = ++definition_versions_sequence_;
+}
+
+std::size_t ObjectiveFunctionBase::GetHessianEntriesLayoutVersion() const
+{
+	return hessian_entries_layout_version_;
+}
+
+std::size_t ObjectiveFunctionBase::GetDefinitionVersion() const
+{
+	return definition_version_;
+}
+
 ObjectiveFunctionBase::UpdateOptions operator | (const ObjectiveFunctionBase::UpdateOptions lhs, const ObjectiveFunctionBase::UpdateOptions rhs)
 {
 	using T = std::underlying_type_t<ObjectiveFunctionBase::UpdateOptions>;
@@ -7,6 +7,7 @@
 
 // STL includes
 #include <memory>
+#include <functional>
 #include <unordered_map>
 #include <any>
 
@@ -16,19 +17,20 @@
 // Optimization lib includes
 #include <libs/optimization_lib/include/core/core.h>
 #include <libs/optimization_lib/include/core/utils.h>
+#include <libs/optimization_lib/include/core/object_arena.h>
 #include <libs/optimization_lib/include/data_providers/mesh_wrapper.h>
 #include <libs/optimization_lib/include/data_providers/empty_data_provider.h>
 #include <libs/optimization_lib/include/data_providers/plain_data_provider.h>
 #include <libs/optimization_lib/include/data_providers/edge_pair_data_provider.h>
+#include <libs/optimization_lib/include/data_providers/data_provider_registry.h>
 #include <libs/optimization_lib/include/objective_functions/summation_objective.h>
 #include <libs/optimization_lib/include/objective_functions/position/face_position_objective.h>
 #include <libs/optimization_lib/include/objective_functions/separation_objective.h>
 #include <libs/optimization_lib/include/objective_functions/symmetric_dirichlet_objective.h>
-#include <libs/optimization_lib/include/objective_functions/seamless_objective.h>
+#include <libs/optimization_lib/include/objective_functions/batched_seamless_objective.h>
 #include <libs/optimization_lib/include/objective_functions/singularity/singular_points_position_objective.h>
 #include <libs/optimization_lib/include/iterative_methods/newton_method.h>
-#include <libs/optimization_lib/include/solvers/eigen_sparse_solver.h>
-#include <libs/optimization_lib/include/solvers/pardiso_solver.h>
+#include <libs/optimization_lib/include/solvers/default_solver.h>
 
 class Engine : public Napi::ObjectWrap<Engine> {
 public:
@@ -92,6 +94,7 @@ private:
 	void SetSeamlessWeight(const Napi::CallbackInfo& info, const Napi::Value& value);
 	void SetLambda(const Napi::CallbackInfo& info, const Napi::Value& value);
 	void SetDelta(const Napi::CallbackInfo& info, const Napi::Value& value);
+	void SetMaxHessianLag(const Napi::CallbackInfo& info, const Napi::Value& value);
 
 	/**
 	 * NAPI private instance getters
@@ -100,6 +103,7 @@ private:
 	Napi::Value GetSeamlessWeight(const Napi::CallbackInfo& info);
 	Napi::Value GetLambda(const Napi::CallbackInfo& info);
 	Napi::Value GetDelta(const Napi::CallbackInfo& info);
+	Napi::Value GetMaxHessianLag(const Napi::CallbackInfo& info);
 	Napi::Value GetObjectiveFunctionsData(const Napi::CallbackInfo& info);
 
 	/**
@@ -145,6 +149,8 @@ private:
 	 */
 	ModelFileType GetModelFileType(std::string filename);
 	void TryUpdateImageVertices();
+	void RunBetweenIterations(std::function<void()> function);
+	void RequestDiagnosticsPublication(const std::shared_ptr<ObjectiveFunction<Eigen::StorageOptions::RowMajor, Eigen::VectorXd>>& objective_function);
 	Napi::Int32Array GetBufferedFaces(const Napi::CallbackInfo& info, const FacesSource faces_source) const;
 	Napi::Int32Array GetBufferedEdges(const Napi::CallbackInfo& info, const EdgesSource edges_source) const;
 	Napi::Float32Array GetBufferedVertices(const Napi::CallbackInfo& info, const VerticesSource vertices_source);
@@ -318,7 +324,7 @@ private:
 	std::shared_ptr<SummationObjective<ObjectiveFunction<Eigen::StorageOptions::RowMajor, Eigen::VectorXd>, Eigen::VectorXd>> position_;
 	std::shared_ptr<Separation<Eigen::StorageOptions::RowMajor>> separation_;
 	std::shared_ptr<SymmetricDirichlet<Eigen::StorageOptions::RowMajor>> symmetric_dirichlet_;
-	std::shared_ptr<SeamlessObjective<Eigen::StorageOptions::RowMajor>> seamless_;
+	std::shared_ptr<BatchedSeamlessObjective<Eigen::StorageOptions::RowMajor>> seamless_;
 	std::shared_ptr<SingularPointsPositionObjective<Eigen::StorageOptions::RowMajor>> singular_points_;
 	std::vector<std::shared_ptr<ObjectiveFunction<Eigen::StorageOptions::RowMajor, Eigen::VectorXd>>> objective_functions_;
 	std::vector<std::shared_ptr<ObjectiveFunction<Eigen::StorageOptions::RowMajor, Eigen::VectorXd>>> autocuts_objective_functions_;
@@ -326,7 +332,8 @@ private:
 
 
 	
-	std::unique_ptr<NewtonMethod<PardisoSolver, Eigen::StorageOptions::RowMajor>> newton_method_;
+	std::unique_ptr<NewtonMethod<DefaultSolver, Eigen::StorageOptions::RowMajor>> newton_method_;
+	int64_t max_hessian_lag_;
 	std::vector<Eigen::DenseIndex> constrained_faces_indices;
 	Eigen::MatrixX2d image_vertices_;
 	std::unordered_map<std::string, uint32_t> properties_map_;
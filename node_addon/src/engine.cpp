@@ -6,6 +6,9 @@
 #include <igl/readOFF.h>
 #include <igl/readOBJ.h>
 
+// TBB includes
+#include <tbb/parallel_for.h>
+
 // Optimization lib includes
 #include "../include/engine.h"
 #include "libs/optimization_lib/include/objective_functions/objective_function.h"
@@ -60,6 +63,7 @@ Napi::Object Engine::Init(Napi::Env env, Napi::Object exports)
 		InstanceAccessor("seamlessWeight", &Engine::GetSeamlessWeight, &Engine::SetSeamlessWeight),
 		InstanceAccessor("lambda", &Engine::GetLambda, &Engine::SetLambda),
 		InstanceAccessor("delta", &Engine::GetDelta, &Engine::SetDelta),
+		InstanceAccessor("maxHessianLag", &Engine::GetMaxHessianLag, &Engine::SetMaxHessianLag),
 		InstanceAccessor("objectiveFunctionsData", &Engine::GetObjectiveFunctionsData, nullptr)
 	});
 
@@ -72,7 +76,8 @@ Napi::Object Engine::Init(Napi::Env env, Napi::Object exports)
 
 Engine::Engine(const Napi::CallbackInfo& info) : 
 	Napi::ObjectWrap<Engine>(info),
-	mesh_wrapper_(std::make_shared<MeshWrapper>())
+	mesh_wrapper_(std::make_shared<MeshWrapper>()),
+	max_hessian_lag_(0)
 {
 	properties_map_.insert({ "value", static_cast<uint32_t>(ObjectiveFunctionBase::Properties::Value) });
 	properties_map_.insert({ "value_per_vertex", static_cast<uint32_t>(ObjectiveFunctionBase::Properties::ValuePerVertex) });
@@ -83,15 +88,17 @@ Engine::Engine(const Napi::CallbackInfo& info) :
 	properties_map_.insert({ "weight", static_cast<uint32_t>(ObjectiveFunctionBase::Properties::Weight) });
 	properties_map_.insert({ "name", static_cast<uint32_t>(ObjectiveFunctionBase::Properties::Name) });
 	properties_map_.insert({ "delta", static_cast<uint32_t>(Separation<Eigen::StorageOptions::RowMajor>::Properties::Delta) });
-	properties_map_.insert({ "zeta", static_cast<uint32_t>(SeamlessObjective<Eigen::StorageOptions::RowMajor>::Properties::Zeta) });
-	properties_map_.insert({ "angle_value_per_edge", static_cast<uint32_t>(SeamlessObjective<Eigen::StorageOptions::RowMajor>::Properties::AngleValuePerEdge) });
-	properties_map_.insert({ "length_value_per_edge", static_cast<uint32_t>(SeamlessObjective<Eigen::StorageOptions::RowMajor>::Properties::LengthValuePerEdge) });
-	properties_map_.insert({ "edge_angle_weight", static_cast<uint32_t>(SeamlessObjective<Eigen::StorageOptions::RowMajor>::Properties::EdgeAngleWeight) });
-	properties_map_.insert({ "edge_length_weight", static_cast<uint32_t>(SeamlessObjective<Eigen::StorageOptions::RowMajor>::Properties::EdgeLengthWeight) });
-	properties_map_.insert({ "angle_weight", static_cast<uint32_t>(SeamlessObjective<Eigen::StorageOptions::RowMajor>::Properties::AngleWeight) });
-	properties_map_.insert({ "length_weight", static_cast<uint32_t>(SeamlessObjective<Eigen::StorageOptions::RowMajor>::Properties::LengthWeight) });
-	properties_map_.insert({ "translation_weight", static_cast<uint32_t>(SeamlessObjective<Eigen::StorageOptions::RowMajor>::Properties::TranslationWeight) });
-	properties_map_.insert({ "translation_interval", static_cast<uint32_t>(SeamlessObjective<Eigen::StorageOptions::RowMajor>::Properties::Interval) });
+	properties_map_.insert({ "zeta", static_cast<uint32_t>(BatchedSeamlessObjective<Eigen::StorageOptions::RowMajor>::Properties::Zeta) });
+	properties_map_.insert({ "angle_value_per_edge", static_cast<uint32_t>(BatchedSeamlessObjective<Eigen::StorageOptions::RowMajor>::Properties::AngleValuePerEdge) });
+	properties_map_.insert({ "length_value_per_edge", static_cast<uint32_t>(BatchedSeamlessObjective<Eigen::StorageOptions::RowMajor>::Properties::LengthValuePerEdge) });
+	properties_map_.insert({ "edge_angle_weight", static_cast<uint32_t>(BatchedSeamlessObjective<Eigen::StorageOptions::RowMajor>::Properties::EdgeAngleWeight) });
+	properties_map_.insert({ "edge_length_weight", static_cast<uint32_t>(BatchedSeamlessObjective<Eigen::StorageOptions::RowMajor>::Properties::EdgeLengthWeight) });
+	properties_map_.insert({ "edge_angle_weights", static_cast<uint32_t>(BatchedSeamlessObjective<Eigen::StorageOptions::RowMajor>::Properties::EdgeAngleWeights) });
+	properties_map_.insert({ "edge_length_weights", static_cast<uint32_t>(BatchedSeamlessObjective<Eigen::StorageOptions::RowMajor>::Properties::EdgeLengthWeights) });
+	properties_map_.insert({ "angle_weight", static_cast<uint32_t>(BatchedSeamlessObjective<Eigen::StorageOptions::RowMajor>::Properties::AngleWeight) });
+	properties_map_.insert({ "length_weight", static_cast<uint32_t>(BatchedSeamlessObjective<Eigen::StorageOptions::RowMajor>::Properties::LengthWeight) });
+	properties_map_.insert({ "translation_weight", static_cast<uint32_t>(BatchedSeamlessObjective<Eigen::StorageOptions::RowMajor>::Properties::TranslationWeight) });
+	properties_map_.insert({ "translation_interval", static_cast<uint32_t>(BatchedSeamlessObjective<Eigen::StorageOptions::RowMajor>::Properties::Interval) });
 	properties_map_.insert({ "interval", static_cast<uint32_t>(SingularPointsPositionObjective<Eigen::StorageOptions::RowMajor>::Properties::Interval) });
 	properties_map_.insert({ "singularity_weight_per_vertex", static_cast<uint32_t>(SingularPointsPositionObjective<Eigen::StorageOptions::RowMajor>::Properties::SingularityWeightPerVertex) });
 	properties_map_.insert({ "negative_angular_defect_singularities_indices", static_cast<uint32_t>(SingularPointsPositionObjective<Eigen::StorageOptions::RowMajor>::Properties::NegativeAngularDefectSingularitiesIndices) });
@@ -101,13 +108,13 @@ Engine::Engine(const Napi::CallbackInfo& info) :
 	property_modifiers_map_.insert({ "domain", static_cast<uint32_t>(ObjectiveFunctionBase::PropertyModifiers::Domain) });
 	property_modifiers_map_.insert({ "image", static_cast<uint32_t>(ObjectiveFunctionBase::PropertyModifiers::Image) });
 	
-	empty_data_provider_ = std::make_shared<EmptyDataProvider>(mesh_wrapper_);
+	empty_data_provider_ = DataProviderRegistry::GetEmptyDataProvider(mesh_wrapper_);
 	plain_data_provider_ = std::make_shared<PlainDataProvider>(mesh_wrapper_);
 	
 	// TODO: Expose interface for addition and removal of objective function
 	separation_ = std::make_shared<Separation<Eigen::StorageOptions::RowMajor>>(mesh_wrapper_, empty_data_provider_);
 	symmetric_dirichlet_ = std::make_shared<SymmetricDirichlet<Eigen::StorageOptions::RowMajor>>(mesh_wrapper_, empty_data_provider_);
-	seamless_ = std::make_shared<SeamlessObjective<Eigen::StorageOptions::RowMajor>>(mesh_wrapper_, empty_data_provider_);
+	seamless_ = std::make_shared<BatchedSeamlessObjective<Eigen::StorageOptions::RowMajor>>(mesh_wrapper_, empty_data_provider_);
 	singular_points_ = std::make_shared<SingularPointsPositionObjective<Eigen::StorageOptions::RowMajor>>(mesh_wrapper_, empty_data_provider_, 1);
   	position_ = std::make_shared<SummationObjective<ObjectiveFunction<Eigen::StorageOptions::RowMajor, Eigen::VectorXd>, Eigen::VectorXd>>(mesh_wrapper_, empty_data_provider_, std::string("Position"));
 
@@ -143,42 +150,40 @@ Engine::Engine(const Napi::CallbackInfo& info) :
 		face_to_face_data_provider_map_.clear();
 		for (auto& face : mesh_wrapper_->GetImageFacesSTL())
 		{
-			auto face_data_provider = std::make_shared<FaceDataProvider>(mesh_wrapper_, face);
+			auto face_data_provider = mesh_wrapper_->GetObjectArena().MakeShared<FaceDataProvider>(mesh_wrapper_, face);
 			face_data_providers_.push_back(face_data_provider);
 			face_to_face_data_provider_map_.insert(std::make_pair(face, face_data_provider));
 		}
 
 		const auto edge_pair_descriptors = mesh_wrapper_->GetEdgePairDescriptors();
 		edge_pair_data_providers_.resize(edge_pair_descriptors.size());
-		#pragma omp parallel for
-		for (int64_t i = 0; i < edge_pair_descriptors.size(); i++)
+		tbb::parallel_for(static_cast<int64_t>(0), static_cast<int64_t>(edge_pair_descriptors.size()), [&](const int64_t i)
 		{
 			auto edge_pair_descriptor = edge_pair_descriptors[i];
-			const auto edge_pair_data_provider = std::make_shared<EdgePairDataProvider>(mesh_wrapper_, edge_pair_descriptor);
+			const auto edge_pair_data_provider = DataProviderRegistry::GetEdgePairDataProvider(mesh_wrapper_, edge_pair_descriptor);
 			edge_pair_data_providers_[i] = edge_pair_data_provider;
-		}
+		});
 
 		const auto face_fans = mesh_wrapper_->GetFaceFans();
 		face_fan_data_providers_.resize(face_fans.size());
-		#pragma omp parallel for
-		for (int64_t i = 0; i < face_fans.size(); i++)
+		tbb::parallel_for(static_cast<int64_t>(0), static_cast<int64_t>(face_fans.size()), [&](const int64_t i)
 		{
 			auto face_fan = face_fans[i];
-			const auto face_fan_data_provider = std::make_shared<FaceFanDataProvider>(mesh_wrapper_, face_fan);
+			const auto face_fan_data_provider = DataProviderRegistry::GetFaceFanDataProvider(mesh_wrapper_, face_fan);
 			face_fan_data_providers_[i] = face_fan_data_provider;
-		}
+		});
 
-		#pragma omp parallel for
-		for (int64_t i = 0; i < edge_pair_data_providers_.size(); i++)
+		tbb::parallel_for(static_cast<int64_t>(0), static_cast<int64_t>(edge_pair_data_providers_.size()), [&](const int64_t i)
 		{
 			seamless_->AddEdgePairObjectives(edge_pair_data_providers_[i]);
-		}
+		});
 
-		#pragma omp parallel for
-		for (int64_t i = 0; i < face_fan_data_providers_.size(); i++)
+		seamless_->Initialize();
+
+		tbb::parallel_for(static_cast<int64_t>(0), static_cast<int64_t>(face_fan_data_providers_.size()), [&](const int64_t i)
 		{
 			singular_points_->AddSingularPointObjective(face_fan_data_providers_[i]);
-		}
+		});
 
 		autocuts_summation_objective_->Initialize();
 		//autoquads_summation_objective_->Initialize();
@@ -188,8 +193,9 @@ Engine::Engine(const Napi::CallbackInfo& info) :
 		 */
 		auto image_vertices = mesh_wrapper_->GetImageVertices();
 		auto x0 = Eigen::Map<const Eigen::VectorXd>(image_vertices.data(), image_vertices.cols() * image_vertices.rows());
-		newton_method_ = std::make_unique<NewtonMethod<PardisoSolver, Eigen::StorageOptions::RowMajor>>(summation_objective_, x0);
+		newton_method_ = std::make_unique<NewtonMethod<DefaultSolver, Eigen::StorageOptions::RowMajor>>(summation_objective_, x0);
 		newton_method_->EnableFlipAvoidingLineSearch(mesh_wrapper_->GetImageFaces());
+		newton_method_->SetMaxHessianLag(max_hessian_lag_);
 	});
 }
 
@@ -612,7 +618,11 @@ Napi::Value Engine::GetObjectiveFunctionProperty(const Napi::CallbackInfo& info)
 		const uint32_t property_id = properties_map_.at(property_name);
 		const uint32_t property_modifier_id = property_modifiers_map_.at(property_modifier_name);
 		std::any any_value;
-		if (objective_function->GetProperty(property_id, property_modifier_id, JSToNative(env, info[3]), any_value))
+
+		// Values per vertex and per edge are read from their latest publication, so reads never wait for an iteration to complete
+		const bool has_property = objective_function->GetProperty(property_id, property_modifier_id, JSToNative(env, info[3]), any_value);
+		RequestDiagnosticsPublication(objective_function);
+		if (has_property)
 		{
 			return NativeToJS(env, any_value);
 		}
@@ -673,12 +683,31 @@ Napi::Value Engine::SetObjectiveFunctionProperty(const Napi::CallbackInfo& info)
 	const std::string property_name = info[1].ToString();
 	if (properties_map_.find(property_name) != properties_map_.end())
 	{
-		const uint32_t property_id = properties_map_.at(property_name);
-		if(!objective_function->SetProperty(property_id, JSToNative(env, info[2]), JSToNative(env, info[3])))
+		// Bulk per-edge weights are indexed by domain edge index
+		if (property_name == "edge_angle_weights" || property_name == "edge_length_weights")
 		{
-			Napi::TypeError::New(env, "Couldn't set property").ThrowAsJavaScriptException();
+			if (info.Length() < 4 || !info[3].IsTypedArray() || info[3].As<Napi::TypedArray>().TypedArrayType() != napi_float64_array)
+			{
+				Napi::TypeError::New(env, "Fourth argument is expected to be a Float64Array").ThrowAsJavaScriptException();
+				return Napi::Value();
+			}
+
+			if (info[3].As<Napi::Float64Array>().ElementLength() != mesh_wrapper_->GetDomainEdgesCount())
+			{
+				Napi::TypeError::New(env, "Fourth argument is expected to hold a weight per domain edge").ThrowAsJavaScriptException();
+				return Napi::Value();
+			}
 		}
 
+		// Properties are set between iterations, so setting them never waits for an iteration to complete (and setting a property that the
+		// objective function does not have is ignored, since it can't be reported back)
+		const uint32_t property_id = properties_map_.at(property_name);
+		const std::any property_context = JSToNative(env, info[2]);
+		const std::any property_value = JSToNative(env, info[3]);
+		RunBetweenIterations([objective_function, property_id, property_context, property_value]() {
+			objective_function->SetProperty(property_id, property_context, property_value);
+		});
+
 		return Napi::Value();
 	}
 
@@ -799,6 +828,13 @@ std::any Engine::JSToNative(Napi::Env env, const Napi::Value& value)
 		return std::make_any<double>(value.ToNumber());
 	}
 
+	// Typed arrays (e.g., per-edge weights) are copied in a single pass
+	if (value.IsTypedArray() && value.As<Napi::TypedArray>().TypedArrayType() == napi_float64_array)
+	{
+		auto array = value.As<Napi::Float64Array>();
+		return std::make_any<Eigen::VectorXd>(Eigen::Map<const Eigen::VectorXd>(array.Data(), array.ElementLength()));
+	}
+
 	if (value.IsArray())
 	{
 		auto array = value.As<Napi::Array>();
@@ -861,6 +897,29 @@ void Engine::TryUpdateImageVertices()
 	}
 }
 
+void Engine::RunBetweenIterations(std::function<void()> function)
+{
+	// Objective functions (and their dependency graphs) may only be edited between iterations of the iterative method
+	if (newton_method_)
+	{
+		newton_method_->RunBetweenIterations(std::move(function));
+		return;
+	}
+
+	function();
+}
+
+void Engine::RequestDiagnosticsPublication(const std::shared_ptr<ObjectiveFunction<Eigen::StorageOptions::RowMajor, Eigen::VectorXd>>& objective_function)
+{
+	// Diagnostics that were read are published again for the next read (a single publication is pending at a time)
+	if (objective_function->RequestDiagnosticsPublication())
+	{
+		RunBetweenIterations([objective_function]() {
+			objective_function->PublishDiagnostics();
+		});
+	}
+}
+
 void Engine::SetPositionWeight(const Napi::CallbackInfo& info, const Napi::Value& value)
 {
 	Napi::Env env = info.Env();
@@ -990,6 +1049,41 @@ Napi::Value Engine::GetDelta(const Napi::CallbackInfo& info)
 	return delta;
 }
 
+void Engine::SetMaxHessianLag(const Napi::CallbackInfo& info, const Napi::Value& value)
+{
+	Napi::Env env = info.Env();
+	Napi::HandleScope scope(env);
+
+	/**
+	 * Validate input arguments
+	 */
+	if (!value.IsNumber())
+	{
+		Napi::TypeError::New(env, "value is expected to be a Number").ThrowAsJavaScriptException();
+		return;
+	}
+
+	/**
+	 * Set max hessian lag (number of newton iterations that may reuse the last hessian factorization)
+	 */
+	Napi::Number number = value.As<Napi::Number>();
+	max_hessian_lag_ = number.Int64Value();
+	if (newton_method_)
+	{
+		newton_method_->SetMaxHessianLag(max_hessian_lag_);
+	}
+}
+
+Napi::Value Engine::GetMaxHessianLag(const Napi::CallbackInfo& info)
+{
+	Napi::Env env = info.Env();
+	Napi::HandleScope scope(env);
+
+	Napi::Number max_hessian_lag = Napi::Number::New(env, max_hessian_lag_);
+
+	return max_hessian_lag;
+}
+
 Napi::Value Engine::CreateObjectiveFunctionDataObject(Napi::Env env, std::shared_ptr<ObjectiveFunction<Eigen::StorageOptions::RowMajor, Eigen::VectorXd>> objective_function) const
 {
 	Napi::Object data_object = Napi::Object::New(env);
@@ -1001,10 +1095,12 @@ Napi::Value Engine::CreateObjectiveFunctionDataObject(Napi::Env env, std::shared
 	data_object_internal.Set("value", objective_function->GetValue());
 	data_object_internal.Set("gradientNorm", objective_function->GetGradient().norm());
 
-	auto value_per_vertex = objective_function->GetValuePerVertex();
-	for (int32_t i = 0; i < value_per_vertex.rows(); i++)
+	// The value per vertex is read from its latest publication
+	const auto value_per_vertex = objective_function->GetPublishedValuePerVertex();
+	const int32_t image_vertices_count = mesh_wrapper_->GetImageVerticesCount();
+	for (int32_t i = 0; i < image_vertices_count; i++)
 	{
-		value_per_vertex_array[i] = Napi::Number::New(env, value_per_vertex.coeffRef(i));
+		value_per_vertex_array[i] = Napi::Number::New(env, i < value_per_vertex.rows() ? value_per_vertex.coeff(i) : 0);
 	}
 
 	return data_object;
@@ -1017,12 +1113,15 @@ Napi::Value Engine::GetObjectiveFunctionsData(const Napi::CallbackInfo& info)
 
 	auto objective_functions_count = summation_objective_->GetObjectiveFunctionsCount();
 	Napi::Array objective_functions_data_array = Napi::Array::New(env, objective_functions_count + 1);
-	for (std::uint32_t index = 0; index < summation_objective_->GetObjectiveFunctionsCount(); index++)
+	for (std::uint32_t index = 0; index < objective_functions_count; index++)
 	{
-		objective_functions_data_array[index] = CreateObjectiveFunctionDataObject(env, summation_objective_->GetObjectiveFunction(index));
+		const auto objective_function = summation_objective_->GetObjectiveFunction(index);
+		objective_functions_data_array[index] = CreateObjectiveFunctionDataObject(env, objective_function);
+		RequestDiagnosticsPublication(objective_function);
 	}
 
 	objective_functions_data_array[objective_functions_count] = CreateObjectiveFunctionDataObject(env, summation_objective_);
+	RequestDiagnosticsPublication(summation_objective_);
 
 	return objective_functions_data_array;
 }
@@ -1156,11 +1255,9 @@ Napi::Value Engine::SetAlgorithmType(const Napi::CallbackInfo& info)
 			break;
 		}
 
-		Eigen::VectorXd x0 = newton_method_->GetX();
+		// Keep the same newton method (and solver), so previously analyzed hessian patterns are not reordered again
 		newton_method_->Terminate();
-		newton_method_.release();
-		newton_method_ = std::make_unique<NewtonMethod<PardisoSolver, Eigen::StorageOptions::RowMajor>>(summation_objective_, x0);
-		newton_method_->EnableFlipAvoidingLineSearch(mesh_wrapper_->GetImageFaces());
+		newton_method_->SetObjectiveFunction(summation_objective_);
 		newton_method_->Start();
 	}
 	return env.Null();
@@ -1197,9 +1294,13 @@ Napi::Value Engine::ConstrainFacePosition(const Napi::CallbackInfo& info)
 	Eigen::Vector2d barycenter = Utils::CalculateBarycenter(face, V_im);
 	auto face_data_provider = face_to_face_data_provider_map_.at(face);
 	auto barycenter_position_objective = std::make_shared<FaceBarycenterPositionObjective<Eigen::StorageOptions::RowMajor>>(mesh_wrapper_, face_data_provider, barycenter);
-	position_->AddObjectiveFunction(barycenter_position_objective);
-	summation_objective_->Initialize();
+
+	// The constraint is added between iterations, so dragging a face never waits for an iteration to complete
 	face_to_position_objective_map_.insert(std::make_pair(face, barycenter_position_objective));
+	RunBetweenIterations([position = position_, summation_objective = summation_objective_, barycenter_position_objective]() {
+		position->AddObjectiveFunction(barycenter_position_objective);
+		summation_objective->OnDependencyAdded(*position, barycenter_position_objective);
+	});
 
 	return Napi::Value();
 }
@@ -1280,9 +1381,14 @@ Napi::Value Engine::UnconstrainFacePosition(const Napi::CallbackInfo& info)
 	int64_t face_index = info[0].As<Napi::Number>().Int64Value();
 	RDS::Face face = mesh_wrapper_->GetImageFaceVerticesIndicesSTL(face_index);
 
-	position_->RemoveObjectiveFunction(face_to_position_objective_map_.at(face));
-	summation_objective_->Initialize();
+	auto barycenter_position_objective = face_to_position_objective_map_.at(face);
+
+	// The constraint is removed between iterations (after it was added, if that is still pending)
 	face_to_position_objective_map_.erase(face);
+	RunBetweenIterations([position = position_, summation_objective = summation_objective_, barycenter_position_objective]() {
+		position->RemoveObjectiveFunction(barycenter_position_objective);
+		summation_objective->OnDependencyRemoved(*position, barycenter_position_objective);
+	});
 
 	return Napi::Value();
 }
\ No newline at end of file
@@ -4,6 +4,11 @@
 // STL includes
 #include <memory>
 #include <filesystem>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <chrono>
 
 // Optimization lib includes
 #include <libs/optimization_lib/include/core/utils.h>
@@ -14,6 +19,7 @@
 #include <libs/optimization_lib/include/data_providers/coordinate_data_provider.h>
 #include <libs/optimization_lib/include/data_providers/edge_pair_data_provider.h>
 #include <libs/optimization_lib/include/data_providers/face_fan_data_provider.h>
+#include <libs/optimization_lib/include/data_providers/face_data_provider.h>
 #include <libs/optimization_lib/include/objective_functions/objective_function.h>
 #include <libs/optimization_lib/include/objective_functions/composite_objective.h>
 #include <libs/optimization_lib/include/objective_functions/edge_pair/edge_pair_angle_objective.h>
@@ -25,7 +31,157 @@
 #include <libs/optimization_lib/include/objective_functions/singularity/singular_point_position_objective.h>
 #include <libs/optimization_lib/include/objective_functions/singularity/singular_points_position_objective.h>
 #include <libs/optimization_lib/include/objective_functions/seamless_objective.h>
+#include <libs/optimization_lib/include/objective_functions/batched_seamless_objective.h>
 #include <libs/optimization_lib/include/objective_functions/separation_objective.h>
+#include <libs/optimization_lib/include/objective_functions/symmetric_dirichlet_objective.h>
+#include <libs/optimization_lib/include/objective_functions/summation_objective.h>
+#include <libs/optimization_lib/include/objective_functions/position/face_barycenter_position_objective.h>
+#include <libs/optimization_lib/include/iterative_methods/gradient_descent.h>
+#include <libs/optimization_lib/include/iterative_methods/lbfgs_method.h>
+#include <libs/optimization_lib/include/iterative_methods/newton_method.h>
+#include <libs/optimization_lib/include/iterative_methods/newton_cg_method.h>
+#include <libs/optimization_lib/include/solvers/eigen_sparse_cholesky_solver.h>
+
+// Counts global heap allocations, through all forms of operator new (Eigen allocates dense storage through its own aligned malloc, which is checked separately)
+static std::atomic<std::size_t> heap_allocations_count = 0;
+
+static void* CountedAllocate(const std::size_t size, const std::size_t alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+{
+	heap_allocations_count++;
+	const std::size_t allocated_size = size == 0 ? 1 : size;
+	if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+	{
+		return std::malloc(allocated_size);
+	}
+
+#ifdef _MSC_VER
+	return _aligned_malloc(allocated_size, alignment);
+#else
+	return std::aligned_alloc(alignment, ((allocated_size + alignment - 1) / alignment) * alignment);
+#endif
+}
+
+static void CountedFree(void* p, const std::size_t alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__) noexcept
+{
+#ifdef _MSC_VER
+	if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+	{
+		_aligned_free(p);
+		return;
+	}
+#endif
+	std::free(p);
+}
+
+void* operator new(std::size_t size)
+{
+	if (void* p = CountedAllocate(size))
+	{
+		return p;
+	}
+
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	if (void* p = CountedAllocate(size, static_cast<std::size_t>(alignment)))
+	{
+		return p;
+	}
+
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return CountedAllocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return CountedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return CountedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p) noexcept
+{
+	CountedFree(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	CountedFree(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	CountedFree(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+	CountedFree(p);
+}
+
+void operator delete(void* p, std::align_val_t alignment) noexcept
+{
+	CountedFree(p, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* p, std::align_val_t alignment) noexcept
+{
+	CountedFree(p, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept
+{
+	CountedFree(p, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t alignment) noexcept
+{
+	CountedFree(p, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+	CountedFree(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+	CountedFree(p);
+}
+
+void operator delete(void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	CountedFree(p, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	CountedFree(p, static_cast<std::size_t>(alignment));
+}
 
 template<Eigen::StorageOptions StorageOrder_, typename VectorType_>
 class FiniteDifferencesTest : public ::testing::Test
@@ -82,6 +238,24 @@ protected:
 		}
 	}
 
+	// Once the objective function was updated once, further updates (of the objective function and its dependencies) must not allocate.
+	// Allocations through operator new are counted in all builds, while Eigen asserts against its own allocations only in debug builds.
+	void AssertAllocationFreeUpdate() const
+	{
+		const auto update_options = ObjectiveFunctionBase::UpdateOptions::Value | ObjectiveFunctionBase::UpdateOptions::Gradient | ObjectiveFunctionBase::UpdateOptions::Hessian;
+		objective_function_->UpdateLayers(x_, update_options);
+
+		const std::size_t initial_heap_allocations_count = heap_allocations_count;
+		Eigen::internal::set_is_malloc_allowed(false);
+		for (int i = 0; i < 100; i++)
+		{
+			objective_function_->UpdateLayers(x_, update_options);
+		}
+		Eigen::internal::set_is_malloc_allowed(true);
+
+		ASSERT_EQ(heap_allocations_count.load(), initial_heap_allocations_count);
+	}
+
 	void AssertHessian(bool symmetric = true) const
 	{
 		objective_function_->UpdateLayers(x_);
@@ -379,6 +553,199 @@ protected:
 	}
 };
 
+class BatchedSeamlessObjectiveFDTest : public FiniteDifferencesTest<Eigen::StorageOptions::RowMajor, Eigen::VectorXd>
+{
+protected:
+	BatchedSeamlessObjectiveFDTest() :
+		FiniteDifferencesTest("../../../models/obj/three_triangles.obj")
+	{
+
+	}
+
+	~BatchedSeamlessObjectiveFDTest() override
+	{
+
+	}
+
+	void CreateDataProvider() override
+	{
+		data_providers_.push_back(std::make_shared<EmptyDataProvider>(mesh_wrapper_));
+
+		auto& edge_pair_descriptors = mesh_wrapper_->GetEdgePairDescriptors();
+		data_providers_.push_back(std::make_shared<EdgePairDataProvider>(mesh_wrapper_, edge_pair_descriptors[0]));
+		data_providers_.push_back(std::make_shared<EdgePairDataProvider>(mesh_wrapper_, edge_pair_descriptors[1]));
+	}
+
+	void CreateObjectiveFunction() override
+	{
+		auto batched_seamless_objective = std::make_shared<BatchedSeamlessObjective<Eigen::StorageOptions::RowMajor>>(
+			mesh_wrapper_,
+			std::static_pointer_cast<EmptyDataProvider>(data_providers_[0]),
+			false);
+
+		seamless_objective_ = std::make_shared<SeamlessObjective<Eigen::StorageOptions::RowMajor>>(
+			mesh_wrapper_,
+			std::static_pointer_cast<EmptyDataProvider>(data_providers_[0]),
+			false);
+
+		for (int i = 1; i <= 2; i++)
+		{
+			batched_seamless_objective->AddEdgePairObjectives(std::static_pointer_cast<EdgePairDataProvider>(data_providers_[i]));
+			seamless_objective_->AddEdgePairObjectives(std::static_pointer_cast<EdgePairDataProvider>(data_providers_[i]));
+		}
+
+		batched_seamless_objective->SetAngleWeight(1);
+		batched_seamless_objective->SetLengthWeight(1);
+		batched_seamless_objective->SetTranslationWeight(1);
+		batched_seamless_objective->Initialize();
+
+		seamless_objective_->SetAngleWeight(1);
+		seamless_objective_->SetLengthWeight(1);
+		seamless_objective_->SetTranslationWeight(1);
+		seamless_objective_->Initialize();
+
+		objective_function_ = batched_seamless_objective;
+	}
+
+	void AssertSeamlessObjectiveEquivalence() const
+	{
+		objective_function_->UpdateLayers(x_);
+		seamless_objective_->UpdateLayers(x_);
+		AssertComponent(seamless_objective_->GetValue(), objective_function_->GetValue());
+
+		const Eigen::VectorXd& g = objective_function_->GetGradient();
+		const Eigen::VectorXd& seamless_g = seamless_objective_->GetGradient();
+		for (uint64_t i = 0; i < g.rows(); i++)
+		{
+			AssertComponent(seamless_g.coeff(i), g.coeff(i));
+		}
+
+		const Eigen::MatrixXd H = objective_function_->GetHessian();
+		const Eigen::MatrixXd seamless_H = seamless_objective_->GetHessian();
+		for (uint64_t row = 0; row < H.rows(); row++)
+		{
+			for (uint64_t col = row; col < H.cols(); col++)
+			{
+				AssertComponent(seamless_H.coeff(row, col), H.coeff(row, col));
+			}
+		}
+	}
+
+	// Sets different angle weights to the edge pairs of both objectives (bulk weights are indexed by domain edge index)
+	void SetEdgeAngleWeights()
+	{
+		Eigen::VectorXd edge_angle_weights(mesh_wrapper_->GetDomainEdgesCount());
+		for (int64_t i = 0; i < edge_angle_weights.rows(); i++)
+		{
+			edge_angle_weights.coeffRef(i) = 0.5 + i;
+		}
+
+		std::static_pointer_cast<BatchedSeamlessObjective<Eigen::StorageOptions::RowMajor>>(objective_function_)->SetEdgeAngleWeights(edge_angle_weights);
+		seamless_objective_->SetEdgeAngleWeights(edge_angle_weights);
+	}
+
+	std::shared_ptr<SeamlessObjective<Eigen::StorageOptions::RowMajor>> seamless_objective_;
+};
+
+class SymmetricDirichletObjectiveFDTest : public FiniteDifferencesTest<Eigen::StorageOptions::RowMajor, Eigen::VectorXd>
+{
+protected:
+	SymmetricDirichletObjectiveFDTest() :
+		FiniteDifferencesTest("../../../models/obj/three_triangles.obj")
+	{
+
+	}
+
+	~SymmetricDirichletObjectiveFDTest() override
+	{
+
+	}
+
+	void SetUp() override
+	{
+		FiniteDifferencesTest::SetUp();
+
+		// The energy is stationary at rigid parameterizations, so the parameterization is sheared and scaled (without inverting faces)
+		const int64_t vertices_count = x_.rows() / 2;
+		auto x_coordinates = x_.head(vertices_count);
+		auto y_coordinates = x_.tail(vertices_count);
+		x_coordinates = 1.3 * x_coordinates + 0.2 * y_coordinates;
+		y_coordinates *= 0.8;
+	}
+
+	void CreateDataProvider() override
+	{
+		data_providers_.push_back(std::make_shared<EmptyDataProvider>(mesh_wrapper_));
+	}
+
+	void CreateObjectiveFunction() override
+	{
+		objective_function_ = std::make_shared<SymmetricDirichlet<Eigen::StorageOptions::RowMajor>>(
+			mesh_wrapper_,
+			std::static_pointer_cast<EmptyDataProvider>(data_providers_[0]));
+	}
+
+	// Compares the value and gradient with the previous evaluation, which took the singular values (and their derivatives) from the signed SVD of each jacobian
+	void AssertSSVDEquivalence() const
+	{
+		objective_function_->UpdateLayers(x_);
+
+		const Eigen::MatrixX3i& F = mesh_wrapper_->GetImageFaces();
+		const Eigen::MatrixX3d& D1 = mesh_wrapper_->GetD1();
+		const Eigen::MatrixX3d& D2 = mesh_wrapper_->GetD2();
+		const int64_t vertices_count = mesh_wrapper_->GetImageVerticesCount();
+
+		Eigen::VectorXd area;
+		igl::doublearea(mesh_wrapper_->GetDomainVertices(), mesh_wrapper_->GetDomainFaces(), area);
+		area /= 2;
+
+		double f = 0;
+		Eigen::VectorXd g = Eigen::VectorXd::Zero(x_.rows());
+		for (int64_t fi = 0; fi < F.rows(); fi++)
+		{
+			const Eigen::Vector3d X1(x_(F(fi, 0)), x_(F(fi, 1)), x_(F(fi, 2)));
+			const Eigen::Vector3d X2(x_(F(fi, 0) + vertices_count), x_(F(fi, 1) + vertices_count), x_(F(fi, 2) + vertices_count));
+			const Eigen::Vector3d D1i = D1.row(fi).transpose();
+			const Eigen::Vector3d D2i = D2.row(fi).transpose();
+
+			Eigen::Matrix2d J;
+			J << D1i.dot(X1), D2i.dot(X1), D1i.dot(X2), D2i.dot(X2);
+
+			Eigen::Matrix2d U, S, V;
+			Utils::SSVD2x2(J, U, S, V);
+
+			const double det = J.determinant();
+			const double dirichlet = J.squaredNorm();
+			const double Efi = dirichlet + dirichlet / (det * det);
+			f += 0.5 * area(fi) * Efi;
+
+			const Eigen::Vector3d B = D1i * V(0) + D2i * V(1);
+			const Eigen::Vector3d C = D1i * V(2) + D2i * V(3);
+			Eigen::Matrix<double, 6, 1> dS;
+			Eigen::Matrix<double, 6, 1> ds;
+			dS << B * U(0), B * U(1);
+			ds << C * U(2), C * U(3);
+
+			const double gS = S(0) - 1.0 / std::pow(S(0), 3);
+			const double gs = S(3) - 1.0 / std::pow(S(3), 3);
+			const Eigen::Matrix<double, 6, 1> gi = area(fi) * (dS * gS + ds * gs);
+			for (int vi = 0; vi < 3; vi++)
+			{
+				g(F(fi, vi)) += gi(vi);
+				g(F(fi, vi) + vertices_count) += gi(vi + 3);
+			}
+		}
+
+		AssertComponent(f, objective_function_->GetValue());
+
+		const Eigen::VectorXd& objective_g = objective_function_->GetGradient();
+		for (uint64_t i = 0; i < g.rows(); i++)
+		{
+			AssertComponent(g.coeff(i), objective_g.coeff(i));
+		}
+	}
+};
+
 class SeparationObjectiveFDTest : public FiniteDifferencesTest<Eigen::StorageOptions::RowMajor, Eigen::VectorXd>
 {
 protected:
@@ -407,6 +774,186 @@ protected:
 	}
 };
 
+// Minimizes a convex objective (the sum of barycenter position constraints over all faces, whose minimum is zero) with the iterative methods
+class FaceBarycenterPositionConvergenceTest : public FiniteDifferencesTest<Eigen::StorageOptions::RowMajor, Eigen::VectorXd>
+{
+protected:
+	FaceBarycenterPositionConvergenceTest() :
+		FiniteDifferencesTest("../../../models/obj/two_triangles_v2.obj")
+	{
+
+	}
+
+	~FaceBarycenterPositionConvergenceTest() override
+	{
+
+	}
+
+	void CreateDataProvider() override
+	{
+		data_providers_.push_back(std::make_shared<EmptyDataProvider>(mesh_wrapper_));
+		for (const auto& face : mesh_wrapper_->GetImageFacesSTL())
+		{
+			data_providers_.push_back(std::make_shared<FaceDataProvider>(mesh_wrapper_, face));
+		}
+	}
+
+	void CreateObjectiveFunction() override
+	{
+		auto position_objective = std::make_shared<SummationObjective<ObjectiveFunction<Eigen::StorageOptions::RowMajor, Eigen::VectorXd>, Eigen::VectorXd>>(
+			mesh_wrapper_,
+			std::static_pointer_cast<EmptyDataProvider>(data_providers_[0]),
+			std::string("Position"));
+
+		// Each face is pulled away from its initial barycenter in a different direction
+		for (std::size_t i = 1; i < data_providers_.size(); i++)
+		{
+			const auto face_data_provider = std::static_pointer_cast<FaceDataProvider>(data_providers_[i]);
+			const Eigen::Vector2d barycenter = Utils::CalculateBarycenter(face_data_provider->GetFace(), mesh_wrapper_->GetImageVertices());
+			const Eigen::Vector2d offset(std::cos(static_cast<double>(i)), std::sin(static_cast<double>(i)));
+			position_objective->AddObjectiveFunction(std::make_shared<FaceBarycenterPositionObjective<Eigen::StorageOptions::RowMajor>>(mesh_wrapper_, face_data_provider, barycenter + offset));
+		}
+
+		position_objective->Initialize();
+		objective_function_ = position_objective;
+	}
+
+	template<typename IterativeMethodType_>
+	void AssertConvergence() const
+	{
+		IterativeMethodType_ iterative_method(objective_function_, x_);
+		iterative_method.Start();
+
+		// The objective function is read between iterations only
+		double value = std::numeric_limits<double>::infinity();
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+		while (value > 1e-10 && std::chrono::steady_clock::now() < deadline)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			auto iteration_lock = iterative_method.LockIteration();
+			value = objective_function_->GetValue();
+		}
+
+		iterative_method.Terminate();
+		ASSERT_LT(value, 1e-10);
+	}
+};
+
+// Solves a symmetric positive definite system given by its upper triangle (as hessians are), and solves it again once its values change
+// (so the symbolic analysis is reused)
+class EigenSparseCholeskySolverTest : public ::testing::Test
+{
+protected:
+	template<Eigen::StorageOptions StorageOrder_>
+	void AssertSolve() const
+	{
+		// A diagonally dominant banded matrix, whose upper triangle has an explicit diagonal
+		const int64_t variables_count = 50;
+		std::vector<Eigen::Triplet<double>> triplets;
+		for (int64_t i = 0; i < variables_count; i++)
+		{
+			triplets.emplace_back(i, i, 4);
+			if (i + 1 < variables_count)
+			{
+				triplets.emplace_back(i, i + 1, -1);
+			}
+
+			if (i + 5 < variables_count)
+			{
+				triplets.emplace_back(i, i + 5, -1);
+			}
+		}
+
+		Eigen::SparseMatrix<double, StorageOrder_> A(variables_count, variables_count);
+		A.setFromTriplets(triplets.begin(), triplets.end());
+		A.makeCompressed();
+
+		const Eigen::MatrixXd full_A = Eigen::MatrixXd(A).selfadjointView<Eigen::Upper>();
+		const Eigen::VectorXd expected_x = Eigen::VectorXd::LinSpaced(variables_count, -1, 1);
+		const Eigen::VectorXd b = full_A * expected_x;
+
+		EigenSparseCholeskySolver<StorageOrder_> solver;
+		solver.AnalyzePattern(A);
+		Eigen::VectorXd x;
+		solver.Solve(A, b, x);
+		ASSERT_LT((x - expected_x).cwiseAbs().maxCoeff(), 1e-10);
+
+		A *= 2;
+		solver.Solve(A, b, x);
+		ASSERT_LT((2 * x - expected_x).cwiseAbs().maxCoeff(), 1e-10);
+	}
+};
+
+// Edits the children of a summation objective between hessian evaluations (as constraint edits do), and compares the hessian (whose entries
+// are remapped only for the edited children) with a hessian assembled from scratch
+class SummationObjectiveHessianPatternTest : public FiniteDifferencesTest<Eigen::StorageOptions::RowMajor, Eigen::VectorXd>
+{
+protected:
+	SummationObjectiveHessianPatternTest() :
+		FiniteDifferencesTest("../../../models/obj/square.obj")
+	{
+
+	}
+
+	~SummationObjectiveHessianPatternTest() override
+	{
+
+	}
+
+	void CreateDataProvider() override
+	{
+		data_providers_.push_back(std::make_shared<EmptyDataProvider>(mesh_wrapper_));
+		for (const auto& face : mesh_wrapper_->GetImageFacesSTL())
+		{
+			data_providers_.push_back(std::make_shared<FaceDataProvider>(mesh_wrapper_, face));
+		}
+	}
+
+	void CreateObjectiveFunction() override
+	{
+		position_objective_ = std::make_shared<SummationObjective<ObjectiveFunction<Eigen::StorageOptions::RowMajor, Eigen::VectorXd>, Eigen::VectorXd>>(
+			mesh_wrapper_,
+			std::static_pointer_cast<EmptyDataProvider>(data_providers_[0]),
+			std::string("Position"));
+
+		// The last face is left unconstrained
+		for (std::size_t i = 1; i < data_providers_.size() - 1; i++)
+		{
+			position_objective_->AddObjectiveFunction(CreateFaceBarycenterPositionObjective(i));
+		}
+
+		position_objective_->Initialize();
+		objective_function_ = position_objective_;
+	}
+
+	std::shared_ptr<FaceBarycenterPositionObjective<Eigen::StorageOptions::RowMajor>> CreateFaceBarycenterPositionObjective(const std::size_t data_provider_index) const
+	{
+		const auto face_data_provider = std::static_pointer_cast<FaceDataProvider>(data_providers_[data_provider_index]);
+		const Eigen::Vector2d barycenter = Utils::CalculateBarycenter(face_data_provider->GetFace(), mesh_wrapper_->GetImageVertices());
+		const Eigen::Vector2d offset(std::cos(static_cast<double>(data_provider_index)), std::sin(static_cast<double>(data_provider_index)));
+		return std::make_shared<FaceBarycenterPositionObjective<Eigen::StorageOptions::RowMajor>>(mesh_wrapper_, face_data_provider, barycenter + offset);
+	}
+
+	void AssertHessianPattern() const
+	{
+		objective_function_->UpdateLayers(x_);
+		const Eigen::MatrixXd H = objective_function_->GetHessian();
+
+		// Assembles the upper-triangle hessian from scratch
+		std::vector<Eigen::Triplet<double>> triplets;
+		objective_function_->AddTriplets(triplets);
+		Eigen::MatrixXd expected_H = Eigen::MatrixXd::Zero(H.rows(), H.cols());
+		for (const auto& triplet : triplets)
+		{
+			expected_H(std::min(triplet.row(), triplet.col()), std::max(triplet.row(), triplet.col())) += triplet.value();
+		}
+
+		ASSERT_LT((H - expected_H).cwiseAbs().maxCoeff(), 1e-12);
+	}
+
+	std::shared_ptr<SummationObjective<ObjectiveFunction<Eigen::StorageOptions::RowMajor, Eigen::VectorXd>, Eigen::VectorXd>> position_objective_;
+};
+
 TEST_F(PeriodicEdgePairAngleObjectiveFDTest, Gradient)
 {
 	AssertGradient();
@@ -437,6 +984,11 @@ TEST_F(PeriodicCoordinateDiffObjectiveFDTest, Hessian)
 	AssertHessian();
 }
 
+TEST_F(PeriodicCoordinateDiffObjectiveFDTest, AllocationFreeUpdate)
+{
+	AssertAllocationFreeUpdate();
+}
+
 TEST_F(EdgePairLengthObjectiveFDTest, Gradient)
 {
 	AssertGradient();
@@ -491,6 +1043,39 @@ TEST_F(SeamlessObjectiveFDTest, Hessian)
 	AssertHessian();
 }
 
+TEST_F(BatchedSeamlessObjectiveFDTest, Gradient)
+{
+	AssertGradient();
+}
+
+TEST_F(BatchedSeamlessObjectiveFDTest, Hessian)
+{
+	AssertHessian();
+}
+
+TEST_F(BatchedSeamlessObjectiveFDTest, SeamlessObjectiveEquivalence)
+{
+	AssertSeamlessObjectiveEquivalence();
+}
+
+TEST_F(BatchedSeamlessObjectiveFDTest, EdgeAngleWeights)
+{
+	SetEdgeAngleWeights();
+	AssertGradient();
+	AssertHessian();
+	AssertSeamlessObjectiveEquivalence();
+}
+
+TEST_F(SymmetricDirichletObjectiveFDTest, Gradient)
+{
+	AssertGradient();
+}
+
+TEST_F(SymmetricDirichletObjectiveFDTest, SSVDEquivalence)
+{
+	AssertSSVDEquivalence();
+}
+
 TEST_F(SeparationObjectiveFDTest, Gradient)
 {
 	AssertGradient();
@@ -500,4 +1085,54 @@ TEST_F(SeparationObjectiveFDTest, Hessian)
 {
 	// NOTE: Must add the concave part of the separation hessian in order for this test to pass
 	AssertHessian();
+}
+
+TEST_F(FaceBarycenterPositionConvergenceTest, GradientDescent)
+{
+	AssertConvergence<GradientDescent<Eigen::StorageOptions::RowMajor>>();
+}
+
+TEST_F(FaceBarycenterPositionConvergenceTest, LBFGSMethod)
+{
+	AssertConvergence<LBFGSMethod<Eigen::StorageOptions::RowMajor>>();
+}
+
+TEST_F(FaceBarycenterPositionConvergenceTest, NewtonMethod)
+{
+	AssertConvergence<NewtonMethod<EigenSparseCholeskySolver<Eigen::StorageOptions::RowMajor>, Eigen::StorageOptions::RowMajor>>();
+}
+
+TEST_F(FaceBarycenterPositionConvergenceTest, NewtonCGMethod)
+{
+	AssertConvergence<NewtonCGMethod<Eigen::StorageOptions::RowMajor>>();
+}
+
+TEST_F(EigenSparseCholeskySolverTest, RowMajorSolve)
+{
+	AssertSolve<Eigen::StorageOptions::RowMajor>();
+}
+
+TEST_F(EigenSparseCholeskySolverTest, ColMajorSolve)
+{
+	AssertSolve<Eigen::StorageOptions::ColMajor>();
+}
+
+TEST_F(SummationObjectiveHessianPatternTest, ChildrenEdits)
+{
+	AssertHessianPattern();
+	const std::size_t hessian_pattern_version = objective_function_->GetHessianPatternVersion();
+
+	// Removing a child and adding it back
+	const auto face_barycenter_position_objective = position_objective_->GetObjectiveFunction(0u);
+	position_objective_->RemoveObjectiveFunction(face_barycenter_position_objective);
+	AssertHessianPattern();
+	position_objective_->AddObjectiveFunction(face_barycenter_position_objective);
+	AssertHessianPattern();
+
+	// Constraining the unconstrained face (its hessian entries lie on the diagonal)
+	position_objective_->AddObjectiveFunction(CreateFaceBarycenterPositionObjective(data_providers_.size() - 1));
+	AssertHessianPattern();
+
+	// All edits fit within the initial hessian structure
+	ASSERT_EQ(objective_function_->GetHessianPatternVersion(), hessian_pattern_version);
 }
\ No newline at end of file